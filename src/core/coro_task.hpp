@@ -0,0 +1,310 @@
+#pragma once
+// C++20协程任务接口, 需要以ENABLE_CXX20=ON编译
+#if !defined(__cpp_impl_coroutine)
+#error "coro_task.hpp requires C++20 coroutines, configure with -DENABLE_CXX20=ON"
+#endif
+
+#include <coroutine>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <type_traits>
+
+#include "src/core/thread_pool.hpp"
+
+template<typename T = void>
+class Task;
+
+namespace coro::detail {
+
+// 所有Task promise的公共部分: 惰性启动, 结束时对称转移到等待者(continuation)
+struct TaskPromiseBase {
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            // 对称转移: 直接切换到等待者, 不增加调用栈深度
+            auto continuation = h.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+    std::coroutine_handle<> continuation{};
+    std::exception_ptr exception{};
+};
+
+template<typename T>
+struct TaskPromise : TaskPromiseBase {
+    Task<T> get_return_object() noexcept;
+
+    template<typename U>
+    void return_value(U&& value) {
+        _value.emplace(std::forward<U>(value));
+    }
+
+    T result() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return std::move(*_value);
+    }
+
+private:
+    // T不要求可默认构造
+    std::optional<T> _value;
+};
+
+template<>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void result() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+// 立即启动, 结束后自动销毁的协程, 仅用于内部桥接(sync_wait / when_all)
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() noexcept {}
+        // 桥接协程内部已经捕获了所有异常
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+} // namespace coro::detail
+
+// 惰性启动的协程任务: 只有被co_await(或sync_wait)时才开始执行, 完成后恢复等待者
+template<typename T>
+class Task {
+public:
+    using promise_type = coro::detail::TaskPromise<T>;
+    using HandleType = std::coroutine_handle<promise_type>;
+
+    Task() noexcept = default;
+    explicit Task(HandleType handle) noexcept : _handle(handle) {}
+
+    ~Task() {
+        if (_handle) {
+            _handle.destroy();
+        }
+    }
+
+    // 禁用拷贝(协程帧只能有一个所有者)
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    // 启用移动
+    Task(Task&& other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (_handle) {
+                _handle.destroy();
+            }
+            _handle = std::exchange(other._handle, nullptr);
+        }
+        return *this;
+    }
+
+    bool valid() const noexcept {
+        return static_cast<bool>(_handle);
+    }
+
+    auto operator co_await() const noexcept {
+        struct Awaiter {
+            HandleType handle;
+
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+
+            // 记录等待者后直接切换到子任务执行
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() {
+                // 空Task(默认构造或已被移走)没有协程帧
+                if (!handle) {
+                    throw std::logic_error("co_await on an empty Task");
+                }
+                return handle.promise().result();
+            }
+        };
+        return Awaiter{_handle};
+    }
+
+private:
+    HandleType _handle{};
+};
+
+namespace coro::detail {
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>{std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+}
+
+} // namespace coro::detail
+
+// ThreadPool执行器适配: co_await executor.schedule() 之后的代码在线程池工作线程上继续执行
+// 调用线程不会阻塞等待, 线程池停止后schedule()会在co_await处抛出std::runtime_error
+class ThreadPoolExecutor {
+public:
+    explicit ThreadPoolExecutor(ThreadPool& pool) noexcept : _pool(&pool) {}
+
+    auto schedule() const noexcept {
+        struct Awaiter {
+            ThreadPool* pool;
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> handle) const {
+                // 返回的future不需要保存, packaged_task的future析构时不会阻塞
+                pool->enqueue([handle]() { handle.resume(); });
+            }
+
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{_pool};
+    }
+
+    ThreadPool& pool() const noexcept {
+        return *_pool;
+    }
+
+private:
+    ThreadPool* _pool;
+};
+
+namespace coro::detail {
+
+template<typename T>
+DetachedTask sync_wait_bridge(Task<T> task, std::promise<T> promise) {
+    // promise保存在协程帧中, 避免调用者在set_value返回前析构promise
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await task;
+            promise.set_value();
+        } else {
+            promise.set_value(co_await task);
+        }
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+}
+
+// when_all的共享状态: 计数初始化为n+1, 多出的1由发起方持有, 避免子任务同步完成时提前恢复等待者
+struct WhenAllState {
+    explicit WhenAllState(std::size_t count) : remaining(count + 1) {}
+
+    void arrive() noexcept {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            continuation.resume();
+        }
+    }
+
+    std::atomic<std::size_t> remaining;
+    std::coroutine_handle<> continuation{};
+    std::exception_ptr exception{};
+    std::atomic<bool> has_exception{false};
+};
+
+template<typename T, typename Slot>
+DetachedTask when_all_child(Task<T> task, WhenAllState& state, [[maybe_unused]] Slot& slot) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await task;
+        } else {
+            slot.emplace(co_await task);
+        }
+    } catch (...) {
+        // 只保留第一个异常
+        if (!state.has_exception.exchange(true, std::memory_order_acq_rel)) {
+            state.exception = std::current_exception();
+        }
+    }
+    state.arrive();
+}
+
+template<typename T, typename Slot>
+struct WhenAllAwaiter {
+    std::vector<Task<T>>& tasks;
+    std::vector<Slot>& slots;
+    WhenAllState& state;
+
+    bool await_ready() const noexcept { return tasks.empty(); }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        state.continuation = handle;
+        for (std::size_t i = 0; i < tasks.size(); ++i) {
+            when_all_child(std::move(tasks[i]), state, slots[i]);
+        }
+        // 释放发起方持有的计数: 若所有子任务都已完成, 不挂起直接继续执行
+        return state.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    void await_resume() const noexcept {}
+};
+
+// void任务没有返回值, 用空类型占位
+struct VoidSlot {};
+
+} // namespace coro::detail
+
+// 阻塞等待任务完成并返回结果, 只能在非线程池线程(如main)上调用
+template<typename T>
+T sync_wait(Task<T> task) {
+    std::promise<T> promise;
+    std::future<T> future = promise.get_future();
+    coro::detail::sync_wait_bridge(std::move(task), std::move(promise));
+    return future.get();
+}
+
+// 并发等待一组任务, 结果顺序与输入一致; 任一子任务抛出异常时, 所有子任务结束后重新抛出第一个异常
+template<typename T>
+Task<std::vector<T>> when_all(std::vector<Task<T>> tasks) {
+    coro::detail::WhenAllState state(tasks.size());
+    std::vector<std::optional<T>> slots(tasks.size());
+    co_await coro::detail::WhenAllAwaiter<T, std::optional<T>>{tasks, slots, state};
+    if (state.exception) {
+        std::rethrow_exception(state.exception);
+    }
+
+    std::vector<T> results;
+    results.reserve(slots.size());
+    for (auto& slot : slots) {
+        results.emplace_back(std::move(*slot));
+    }
+    co_return results;
+}
+
+inline Task<void> when_all(std::vector<Task<void>> tasks) {
+    coro::detail::WhenAllState state(tasks.size());
+    std::vector<coro::detail::VoidSlot> slots(tasks.size());
+    co_await coro::detail::WhenAllAwaiter<void, coro::detail::VoidSlot>{tasks, slots, state};
+    if (state.exception) {
+        std::rethrow_exception(state.exception);
+    }
+}
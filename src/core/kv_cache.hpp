@@ -0,0 +1,580 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+
+// 分页KV缓存配置
+struct KVCacheConfig {
+    // transformer层数
+    std::size_t num_layers = 1;
+    // KV头数(GQA时小于注意力头数)
+    std::size_t num_kv_heads = 1;
+    // 每个头的维度
+    std::size_t head_dim = 64;
+    // 每个块容纳的token数
+    std::size_t block_tokens = 16;
+    // 预分配的显存(主)块数
+    std::size_t num_blocks = 256;
+    // 换出用的内存块数, 0表示不支持换出
+    std::size_t num_swap_blocks = 0;
+};
+
+// token在KV缓存中的物理位置
+struct KVSlot {
+    int32_t block;
+    std::size_t offset;
+};
+
+// 运行统计
+struct KVCacheStats {
+    // 被引用的块数
+    std::size_t used_blocks = 0;
+    // 引用计数为0但保留了前缀内容, 可被复用或淘汰的块数
+    std::size_t cached_blocks = 0;
+    // 空闲块数
+    std::size_t free_blocks = 0;
+    // 所有运行中序列的逻辑token数(共享块按序列重复计数)
+    std::size_t logical_tokens = 0;
+    // 前缀缓存命中的token数 / 查询的token数
+    std::size_t prefix_hit_tokens = 0;
+    std::size_t prefix_query_tokens = 0;
+    // 写时复制次数
+    std::size_t cow_copies = 0;
+    // 淘汰的缓存块数
+    std::size_t evictions = 0;
+    // 换出/换入的序列数
+    std::size_t swap_outs = 0;
+    std::size_t swap_ins = 0;
+
+    double prefix_hit_rate() const {
+        return prefix_query_tokens == 0 ? 0.0
+            : static_cast<double>(prefix_hit_tokens) / static_cast<double>(prefix_query_tokens);
+    }
+};
+
+// 分页KV缓存块管理器(参考vLLM PagedAttention)
+// 1. 所有KV块在构造时一次性预分配, 块大小固定, 用空闲链表O(1)分配/释放(与MemoryPool相同的思路, 用块下标代替指针)
+// 2. 每个序列维护一张块表(逻辑块 -> 物理块), 同一个块号在每一层都有独立的K/V存储
+// 3. 写满且KV已写入(调用者通过mark_computed确认)的块按(父块哈希, token)计算哈希登记到前缀表,
+//    相同前缀的序列直接共享物理块, 引用计数管理
+// 4. 共享块被追加写入时做写时复制(copy-on-write)
+// 5. 块不足时先淘汰LRU的缓存块, 仍不足时把最久未访问的序列换出到内存块
+// 非线程安全, 由调度器单线程调用
+template<typename T = float>
+class PagedKVCache {
+public:
+    explicit PagedKVCache(const KVCacheConfig& config)
+        : _config(config)
+        , _block_elems(config.block_tokens * config.num_kv_heads * config.head_dim) {
+        if (config.num_layers == 0 || config.block_tokens == 0 || config.num_blocks == 0 || _block_elems == 0) {
+            throw std::invalid_argument("PagedKVCache: invalid config");
+        }
+        if (config.num_blocks > static_cast<std::size_t>(std::numeric_limits<int32_t>::max())) {
+            throw std::invalid_argument("PagedKVCache: too many blocks");
+        }
+        _storage.resize(config.num_layers * config.num_blocks * 2 * _block_elems);
+        _swap_storage.resize(config.num_layers * config.num_swap_blocks * 2 * _block_elems);
+        _meta.resize(config.num_blocks);
+
+        // 初始化空闲链表: 所有块串成链表
+        _next_free.resize(config.num_blocks);
+        for (std::size_t i = 0; i < config.num_blocks; ++i) {
+            _next_free[i] = i + 1 < config.num_blocks ? static_cast<int32_t>(i + 1) : -1;
+        }
+        _free_head = 0;
+        _free_count = config.num_blocks;
+
+        _swap_free.reserve(config.num_swap_blocks);
+        for (std::size_t i = config.num_swap_blocks; i > 0; --i) {
+            _swap_free.push_back(static_cast<int32_t>(i - 1));
+        }
+    }
+
+    // 禁用拷贝(预分配的大块内存不应被隐式复制)
+    PagedKVCache(const PagedKVCache&) = delete;
+    PagedKVCache& operator=(const PagedKVCache&) = delete;
+
+    // 启用移动
+    PagedKVCache(PagedKVCache&&) noexcept = default;
+    PagedKVCache& operator=(PagedKVCache&&) noexcept = default;
+
+    // 添加序列并登记prompt, 返回前缀缓存命中的token数(这些token的KV无需重新计算)
+    // 未命中部分的KV由调用者按slot()写入, 写入后调用mark_computed, 之前新分配的块不会被其他序列复用
+    std::size_t add_sequence(int64_t seq_id, const std::vector<int32_t>& prompt) {
+        if (_seqs.count(seq_id) != 0) {
+            throw std::invalid_argument("PagedKVCache: sequence already exists");
+        }
+
+        Sequence seq;
+        seq.tokens = prompt;
+        const std::size_t bt = _config.block_tokens;
+        const std::size_t num_full = prompt.size() / bt;
+        const std::size_t num_total = (prompt.size() + bt - 1) / bt;
+        std::size_t hit_blocks = 0;
+
+        try {
+            // 1. 从头匹配前缀表, 第一个未命中的块之后都不再匹配(哈希是链式的)
+            uint64_t parent = 0;
+            for (std::size_t i = 0; i < num_full; ++i) {
+                const uint64_t h = hash_block(parent, prompt.data() + i * bt);
+                const int32_t b = lookup_prefix(h, prompt.data() + i * bt);
+                if (b < 0) {
+                    break;
+                }
+                acquire_cached(b);
+                seq.blocks.push_back(b);
+                seq.hashes.push_back(h);
+                parent = h;
+                ++hit_blocks;
+            }
+
+            // 2. 剩余部分分配新块; KV尚未写入, 不登记到前缀表
+            for (std::size_t i = hit_blocks; i < num_total; ++i) {
+                seq.blocks.push_back(allocate_block(seq_id));
+            }
+        } catch (...) {
+            // 新分配的块未登记, 直接回到空闲链表; 命中的块回到缓存列表
+            for (int32_t b : seq.blocks) {
+                release_block(b);
+            }
+            throw;
+        }
+
+        seq.computed = hit_blocks * bt;
+        seq.last_access = ++_clock;
+        _seqs.emplace(seq_id, std::move(seq));
+        _stats.prefix_hit_tokens += hit_blocks * bt;
+        _stats.prefix_query_tokens += prompt.size();
+        return hit_blocks * bt;
+    }
+
+    // 追加一个解码出的token, 返回其KV应写入的位置; 序列被换出时会先换入
+    // 写入KV后调用mark_computed, 写满的块才会登记到前缀表
+    KVSlot append_token(int64_t seq_id, int32_t token) {
+        Sequence& seq = get_sequence(seq_id);
+        if (seq.swapped) {
+            swap_in(seq_id);
+        }
+
+        const std::size_t bt = _config.block_tokens;
+        const std::size_t pos = seq.tokens.size();
+        const std::size_t offset = pos % bt;
+        if (offset == 0) {
+            // 需要新块
+            seq.blocks.push_back(allocate_block(seq_id));
+        } else {
+            int32_t& last = seq.blocks.back();
+            if (_meta[last].ref > 1) {
+                // 尾块被其他序列共享: 写时复制
+                const int32_t copy = allocate_block(seq_id);
+                copy_block(_storage, last, _storage, copy);
+                release_block(last);
+                last = copy;
+                ++_stats.cow_copies;
+            }
+        }
+
+        seq.tokens.push_back(token);
+        seq.last_access = ++_clock;
+        return KVSlot{seq.blocks.back(), offset};
+    }
+
+    // 确认前num_tokens个token的KV已写入, 其中写满的块登记到前缀表供后续序列复用
+    // 序列被换出时只记录哈希, 换入时再登记
+    void mark_computed(int64_t seq_id, std::size_t num_tokens) {
+        Sequence& seq = get_sequence(seq_id);
+        if (num_tokens > seq.tokens.size()) {
+            throw std::out_of_range("PagedKVCache: computed length exceeds sequence length");
+        }
+        seq.computed = std::max(seq.computed, num_tokens);
+
+        const std::size_t bt = _config.block_tokens;
+        while ((seq.hashes.size() + 1) * bt <= seq.computed) {
+            const std::size_t i = seq.hashes.size();
+            const uint64_t parent = seq.hashes.empty() ? 0 : seq.hashes.back();
+            const int32_t* block_tokens = seq.tokens.data() + i * bt;
+            const uint64_t h = hash_block(parent, block_tokens);
+            if (!seq.swapped) {
+                register_prefix(seq.blocks[i], h, block_tokens);
+            }
+            seq.hashes.push_back(h);
+        }
+    }
+
+    // 派生子序列(并行采样/beam search), 共享父序列的所有块
+    void fork(int64_t parent_id, int64_t child_id) {
+        if (_seqs.count(child_id) != 0) {
+            throw std::invalid_argument("PagedKVCache: sequence already exists");
+        }
+        Sequence& parent = get_sequence(parent_id);
+        if (parent.swapped) {
+            swap_in(parent_id);
+        }
+        Sequence child = parent;
+        for (int32_t b : child.blocks) {
+            ++_meta[b].ref;
+        }
+        child.last_access = ++_clock;
+        _seqs.emplace(child_id, std::move(child));
+    }
+
+    // 释放序列, 带前缀哈希的块进入缓存列表, 其余块回到空闲链表
+    void free_sequence(int64_t seq_id) {
+        Sequence& seq = get_sequence(seq_id);
+        if (seq.swapped) {
+            for (int32_t b : seq.swap_blocks) {
+                _swap_free.push_back(b);
+            }
+        } else {
+            // 逆序释放, 使前缀的头部块最后进入LRU, 最晚被淘汰
+            for (auto it = seq.blocks.rbegin(); it != seq.blocks.rend(); ++it) {
+                release_block(*it);
+            }
+        }
+        _seqs.erase(seq_id);
+    }
+
+    // 将序列的KV换出到内存块, 释放其占用的显存块(被共享的块仍保留给其他序列)
+    void swap_out(int64_t seq_id) {
+        Sequence& seq = get_sequence(seq_id);
+        if (seq.swapped) {
+            return;
+        }
+        if (_swap_free.size() < seq.blocks.size()) {
+            throw std::runtime_error("PagedKVCache: out of swap blocks");
+        }
+        seq.swap_blocks.clear();
+        for (int32_t b : seq.blocks) {
+            const int32_t s = _swap_free.back();
+            _swap_free.pop_back();
+            copy_block(_storage, b, _swap_storage, s);
+            seq.swap_blocks.push_back(s);
+            release_block(b);
+        }
+        seq.blocks.clear();
+        seq.swapped = true;
+        ++_stats.swap_outs;
+    }
+
+    // 将换出的序列换回显存, 写满的块优先复用前缀表中的相同块
+    void swap_in(int64_t seq_id) {
+        Sequence& seq = get_sequence(seq_id);
+        if (!seq.swapped) {
+            return;
+        }
+        const std::size_t bt = _config.block_tokens;
+        std::vector<int32_t> blocks;
+        blocks.reserve(seq.swap_blocks.size());
+        try {
+            for (std::size_t i = 0; i < seq.swap_blocks.size(); ++i) {
+                const bool full = i < seq.hashes.size();
+                const int32_t* block_tokens = seq.tokens.data() + i * bt;
+                int32_t b = full ? lookup_prefix(seq.hashes[i], block_tokens) : -1;
+                if (b >= 0) {
+                    acquire_cached(b);
+                } else {
+                    b = allocate_block(seq_id);
+                    copy_block(_swap_storage, seq.swap_blocks[i], _storage, b);
+                    if (full) {
+                        register_prefix(b, seq.hashes[i], block_tokens);
+                    }
+                }
+                blocks.push_back(b);
+            }
+        } catch (...) {
+            for (int32_t b : blocks) {
+                release_block(b);
+            }
+            throw;
+        }
+
+        for (int32_t s : seq.swap_blocks) {
+            _swap_free.push_back(s);
+        }
+        seq.swap_blocks.clear();
+        seq.blocks = std::move(blocks);
+        seq.swapped = false;
+        seq.last_access = ++_clock;
+        ++_stats.swap_ins;
+    }
+
+    // 第pos个token的KV位置
+    KVSlot slot(int64_t seq_id, std::size_t pos) const {
+        const Sequence& seq = get_sequence(seq_id);
+        if (seq.swapped || pos >= seq.tokens.size()) {
+            throw std::out_of_range("PagedKVCache: invalid slot");
+        }
+        return KVSlot{seq.blocks[pos / _config.block_tokens], pos % _config.block_tokens};
+    }
+
+    // 序列的块表(逻辑块 -> 物理块), 供注意力算子按块寻址
+    const std::vector<int32_t>& block_table(int64_t seq_id) const {
+        return get_sequence(seq_id).blocks;
+    }
+
+    std::size_t sequence_length(int64_t seq_id) const {
+        return get_sequence(seq_id).tokens.size();
+    }
+
+    bool is_swapped(int64_t seq_id) const {
+        return get_sequence(seq_id).swapped;
+    }
+
+    bool contains(int64_t seq_id) const {
+        return _seqs.count(seq_id) != 0;
+    }
+
+    // 块内K/V数据, 布局为[block_tokens][num_kv_heads][head_dim]
+    T* key_data(std::size_t layer, int32_t block) {
+        return block_data(_storage, _config.num_blocks, layer, block, 0);
+    }
+    T* value_data(std::size_t layer, int32_t block) {
+        return block_data(_storage, _config.num_blocks, layer, block, 1);
+    }
+
+    // 写入一个token在某一层的K/V(各num_kv_heads * head_dim个元素)
+    void write(std::size_t layer, const KVSlot& slot, const T* key, const T* value) {
+        const std::size_t token_elems = _config.num_kv_heads * _config.head_dim;
+        std::memcpy(key_data(layer, slot.block) + slot.offset * token_elems, key, token_elems * sizeof(T));
+        std::memcpy(value_data(layer, slot.block) + slot.offset * token_elems, value, token_elems * sizeof(T));
+    }
+
+    // 块的引用计数
+    int32_t ref_count(int32_t block) const {
+        return _meta.at(block).ref;
+    }
+
+    // 能否不换出任何序列就分配n个块
+    bool can_allocate(std::size_t n) const {
+        return _free_count + _lru.size() >= n;
+    }
+
+    // 剩余的换出块数
+    std::size_t free_swap_blocks() const noexcept {
+        return _swap_free.size();
+    }
+
+    KVCacheStats stats() const {
+        KVCacheStats s = _stats;
+        s.free_blocks = _free_count;
+        s.cached_blocks = _lru.size();
+        s.used_blocks = _config.num_blocks - _free_count - _lru.size();
+        s.logical_tokens = 0;
+        for (const auto& kv : _seqs) {
+            if (!kv.second.swapped) {
+                s.logical_tokens += kv.second.tokens.size();
+            }
+        }
+        return s;
+    }
+
+    const KVCacheConfig& config() const noexcept {
+        return _config;
+    }
+
+    // 单个块(所有层的K和V)占用的字节数
+    std::size_t block_bytes() const noexcept {
+        return _config.num_layers * 2 * _block_elems * sizeof(T);
+    }
+
+private:
+    struct BlockMeta {
+        int32_t ref = 0;
+        // 写满后登记的前缀哈希
+        bool hashed = false;
+        uint64_t hash = 0;
+        // 用于校验哈希冲突的token
+        std::vector<int32_t> tokens;
+        // 位于缓存LRU列表中的位置
+        bool in_lru = false;
+        std::list<int32_t>::iterator lru_it;
+    };
+
+    struct Sequence {
+        std::vector<int32_t> blocks;
+        // 已写满且KV已写入的块的链式哈希
+        std::vector<uint64_t> hashes;
+        std::vector<int32_t> tokens;
+        // KV已写入的token数
+        std::size_t computed = 0;
+        bool swapped = false;
+        std::vector<int32_t> swap_blocks;
+        uint64_t last_access = 0;
+    };
+
+    Sequence& get_sequence(int64_t seq_id) {
+        auto it = _seqs.find(seq_id);
+        if (it == _seqs.end()) {
+            throw std::out_of_range("PagedKVCache: unknown sequence");
+        }
+        return it->second;
+    }
+
+    const Sequence& get_sequence(int64_t seq_id) const {
+        auto it = _seqs.find(seq_id);
+        if (it == _seqs.end()) {
+            throw std::out_of_range("PagedKVCache: unknown sequence");
+        }
+        return it->second;
+    }
+
+    T* block_data(std::vector<T>& storage, std::size_t num_blocks, std::size_t layer, int32_t block, std::size_t kv) {
+        return storage.data() + ((layer * num_blocks + static_cast<std::size_t>(block)) * 2 + kv) * _block_elems;
+    }
+
+    void copy_block(std::vector<T>& src_storage, int32_t src, std::vector<T>& dst_storage, int32_t dst) {
+        const std::size_t src_blocks = &src_storage == &_storage ? _config.num_blocks : _config.num_swap_blocks;
+        const std::size_t dst_blocks = &dst_storage == &_storage ? _config.num_blocks : _config.num_swap_blocks;
+        for (std::size_t layer = 0; layer < _config.num_layers; ++layer) {
+            // 同一层的K和V在内存中相邻, 一次拷贝
+            std::memcpy(block_data(dst_storage, dst_blocks, layer, dst, 0),
+                        block_data(src_storage, src_blocks, layer, src, 0),
+                        2 * _block_elems * sizeof(T));
+        }
+    }
+
+    // 链式哈希(FNV-1a): 块哈希依赖父块哈希, 相同哈希意味着从序列开头起的整个前缀相同
+    uint64_t hash_block(uint64_t parent, const int32_t* tokens) const {
+        uint64_t h = 14695981039346656037ull ^ parent;
+        for (std::size_t i = 0; i < _config.block_tokens; ++i) {
+            h ^= static_cast<uint32_t>(tokens[i]);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    int32_t lookup_prefix(uint64_t hash, const int32_t* tokens) const {
+        auto it = _prefix_table.find(hash);
+        if (it == _prefix_table.end()) {
+            return -1;
+        }
+        const auto& stored = _meta[it->second].tokens;
+        if (!std::equal(stored.begin(), stored.end(), tokens)) {
+            return -1;
+        }
+        return it->second;
+    }
+
+    void register_prefix(int32_t block, uint64_t hash, const int32_t* tokens) {
+        // 已有相同内容的块时保留旧块的登记
+        if (_prefix_table.count(hash) != 0) {
+            return;
+        }
+        BlockMeta& meta = _meta[block];
+        meta.hashed = true;
+        meta.hash = hash;
+        meta.tokens.assign(tokens, tokens + _config.block_tokens);
+        _prefix_table.emplace(hash, block);
+    }
+
+    // 引用一个前缀表中的块, 若在缓存列表中则移出
+    void acquire_cached(int32_t block) {
+        BlockMeta& meta = _meta[block];
+        if (meta.in_lru) {
+            _lru.erase(meta.lru_it);
+            meta.in_lru = false;
+        }
+        ++meta.ref;
+    }
+
+    // 分配一个物理块: 空闲链表 -> 淘汰LRU缓存块 -> 换出最久未访问的其他序列
+    int32_t allocate_block(int64_t requester) {
+        while (true) {
+            if (_free_head >= 0) {
+                // 从空闲链表头取块(O(1)操作)
+                const int32_t b = _free_head;
+                _free_head = _next_free[b];
+                --_free_count;
+                _meta[b].ref = 1;
+                return b;
+            }
+            if (!_lru.empty()) {
+                const int32_t b = _lru.front();
+                _lru.pop_front();
+                BlockMeta& meta = _meta[b];
+                meta.in_lru = false;
+                _prefix_table.erase(meta.hash);
+                meta.hashed = false;
+                meta.tokens.clear();
+                meta.ref = 1;
+                ++_stats.evictions;
+                return b;
+            }
+            if (!preempt_one(requester)) {
+                throw std::runtime_error("PagedKVCache: out of KV blocks");
+            }
+        }
+    }
+
+    // 换出一个最久未访问的运行中序列, 没有可换出的序列时返回false
+    bool preempt_one(int64_t requester) {
+        if (_config.num_swap_blocks == 0) {
+            return false;
+        }
+        int64_t victim = 0;
+        bool found = false;
+        uint64_t oldest = std::numeric_limits<uint64_t>::max();
+        for (const auto& kv : _seqs) {
+            const Sequence& seq = kv.second;
+            if (kv.first == requester || seq.swapped || seq.blocks.empty()) {
+                continue;
+            }
+            if (seq.last_access < oldest && _swap_free.size() >= seq.blocks.size()) {
+                oldest = seq.last_access;
+                victim = kv.first;
+                found = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+        const std::size_t before = _free_count + _lru.size();
+        swap_out(victim);
+        // 换出的块都被其他序列共享时没有释放出任何块, 继续尝试下一个
+        return _free_count + _lru.size() > before || preempt_one(requester);
+    }
+
+    void release_block(int32_t block) {
+        BlockMeta& meta = _meta[block];
+        if (--meta.ref > 0) {
+            return;
+        }
+        if (meta.hashed) {
+            // 保留内容供前缀复用, 按LRU顺序淘汰
+            meta.lru_it = _lru.insert(_lru.end(), block);
+            meta.in_lru = true;
+        } else {
+            _next_free[block] = _free_head;
+            _free_head = block;
+            ++_free_count;
+        }
+    }
+
+private:
+    KVCacheConfig _config;
+    // 单层单个块的K(或V)元素数
+    std::size_t _block_elems;
+    // 显存块存储, 布局为[layer][block][k/v][block_tokens][num_kv_heads][head_dim]
+    std::vector<T> _storage;
+    // 换出块存储, 布局同上
+    std::vector<T> _swap_storage;
+    std::vector<BlockMeta> _meta;
+    // 下标形式的空闲链表
+    std::vector<int32_t> _next_free;
+    int32_t _free_head = -1;
+    std::size_t _free_count = 0;
+    std::vector<int32_t> _swap_free;
+    // 引用计数为0的前缀缓存块, 头部最久未使用
+    std::list<int32_t> _lru;
+    // 前缀哈希 -> 物理块
+    std::unordered_map<uint64_t, int32_t> _prefix_table;
+    std::unordered_map<int64_t, Sequence> _seqs;
+    uint64_t _clock = 0;
+    KVCacheStats _stats;
+};
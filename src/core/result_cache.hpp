@@ -0,0 +1,556 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <type_traits>
+#include <stdexcept>
+#include <utility>
+
+#include "src/core/thread_pool.hpp"
+#if defined(__cpp_impl_coroutine)
+#include "src/core/coro_task.hpp"
+#endif
+
+// 64位xxHash(XXH64), 用于对原始输入字节做快速内容哈希
+inline uint64_t xxhash64(const void* data, std::size_t size, uint64_t seed = 0) {
+    constexpr uint64_t P1 = 11400714785074694791ull;
+    constexpr uint64_t P2 = 14029467366897019727ull;
+    constexpr uint64_t P3 = 1609587929392839161ull;
+    constexpr uint64_t P4 = 9650029242287828579ull;
+    constexpr uint64_t P5 = 2870177450012600261ull;
+
+    auto rotl = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+    auto read64 = [](const uint8_t* p) { uint64_t v; std::memcpy(&v, p, sizeof(v)); return v; };
+    auto read32 = [](const uint8_t* p) { uint32_t v; std::memcpy(&v, p, sizeof(v)); return v; };
+    auto round = [&](uint64_t acc, uint64_t input) {
+        acc += input * P2;
+        acc = rotl(acc, 31);
+        return acc * P1;
+    };
+    auto merge = [&](uint64_t acc, uint64_t val) {
+        acc ^= round(0, val);
+        return acc * P1 + P4;
+    };
+
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* const end = p + size;
+    uint64_t h;
+
+    if (size >= 32) {
+        // 4路并行累加, 每轮处理32字节
+        uint64_t v1 = seed + P1 + P2;
+        uint64_t v2 = seed + P2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - P1;
+        const uint8_t* const limit = end - 32;
+        do {
+            v1 = round(v1, read64(p));
+            v2 = round(v2, read64(p + 8));
+            v3 = round(v3, read64(p + 16));
+            v4 = round(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = merge(h, v1);
+        h = merge(h, v2);
+        h = merge(h, v3);
+        h = merge(h, v4);
+    } else {
+        h = seed + P5;
+    }
+
+    h += static_cast<uint64_t>(size);
+    for (; p + 8 <= end; p += 8) {
+        h ^= round(0, read64(p));
+        h = rotl(h, 27) * P1 + P4;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * P1;
+        h = rotl(h, 23) * P2 + P3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= static_cast<uint64_t>(*p) * P5;
+        h = rotl(h, 11) * P1;
+    }
+
+    // 雪崩混合
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+}
+
+// 结果缓存配置
+struct ResultCacheConfig {
+    // 分片数, 每个分片独立加锁
+    std::size_t num_shards = 16;
+    // 所有分片合计的内存上限(按cost函数统计)
+    std::size_t max_bytes = 256u << 20;
+    // 过期时间, 0表示永不过期
+    std::chrono::milliseconds ttl{0};
+};
+
+// 缓存统计
+struct ResultCacheStats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    // 命中正在计算中的相同请求, 共享同一次计算
+    std::size_t inflight_hits = 0;
+    std::size_t evictions = 0;
+    std::size_t expirations = 0;
+    std::size_t entries = 0;
+    std::size_t bytes = 0;
+
+    double hit_rate() const {
+        const std::size_t total = hits + misses + inflight_hits;
+        return total == 0 ? 0.0 : static_cast<double>(hits + inflight_hits) / static_cast<double>(total);
+    }
+};
+
+namespace result_cache_detail {
+
+template<typename V, typename = void>
+struct HasContiguousData : std::false_type {};
+
+template<typename V>
+struct HasContiguousData<V, std::void_t<decltype(std::declval<const V&>().size()),
+                                        typename V::value_type>> : std::true_type {};
+
+// 默认的内存估算: 容器按元素字节数计算, 其他类型按sizeof
+template<typename V>
+std::size_t default_cache_cost(const V& value) {
+    if constexpr (HasContiguousData<V>::value) {
+        return sizeof(V) + value.size() * sizeof(typename V::value_type);
+    } else {
+        (void)value;
+        return sizeof(V);
+    }
+}
+
+} // namespace result_cache_detail
+
+// 内容寻址的推理结果缓存: 键为(模型id, 输入字节的xxHash64, 输入长度)
+// 1. 按键哈希分片, 每个分片一把锁, 降低并发冲突
+// 2. 分片内用CLOCK(二次机会)算法淘汰: 命中只置访问位, 不需要移动链表节点
+// 3. 支持TTL过期和内存上限
+// 4. 相同键的并发请求只计算一次, 其余请求等待同一个shared_future(in-flight去重)
+// 注意: 只按哈希判等, 不保存原始输入; 64位哈希冲突概率可忽略
+template<typename Value>
+class ResultCache {
+public:
+    using ValuePtr = std::shared_ptr<const Value>;
+    using CostFunc = std::function<std::size_t(const Value&)>;
+    using Clock = std::chrono::steady_clock;
+
+    explicit ResultCache(const ResultCacheConfig& config = ResultCacheConfig(),
+                         CostFunc cost = result_cache_detail::default_cache_cost<Value>)
+        : _config(config)
+        , _cost(std::move(cost))
+        , _shards(config.num_shards == 0 ? 1 : config.num_shards) {
+        _shard_capacity = _config.max_bytes / _shards.size();
+    }
+
+    // 禁用拷贝和移动(分片中含有互斥锁)
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    // 查询缓存, 未命中返回nullptr
+    ValuePtr lookup(const std::string& model_id, const void* data, std::size_t size) {
+        const Key key = make_key(model_id, data, size);
+        Shard& shard = shard_of(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        ValuePtr value = lookup_locked(shard, key);
+        if (value) {
+            _hits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            _misses.fetch_add(1, std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    // 直接写入结果
+    void insert(const std::string& model_id, const void* data, std::size_t size, Value value) {
+        const Key key = make_key(model_id, data, size);
+        Shard& shard = shard_of(key);
+        auto ptr = std::make_shared<const Value>(std::move(value));
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        insert_locked(shard, key, std::move(ptr));
+    }
+
+    // 同步接口: 命中直接返回; 相同请求正在计算时等待其结果; 否则在当前线程执行compute并写入缓存
+    // compute抛出的异常会传给所有等待者, 失败结果不缓存
+    template<typename F>
+    ValuePtr get_or_compute(const std::string& model_id, const void* data, std::size_t size, F&& compute) {
+        const Key key = make_key(model_id, data, size);
+        Shard& shard = shard_of(key);
+        std::shared_ptr<std::promise<ValuePtr>> promise;
+        std::shared_future<ValuePtr> pending;
+        {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            if (auto value = probe_locked(shard, key, pending)) {
+                return value;
+            }
+            if (!pending.valid()) {
+                promise = begin_compute_locked(shard, key);
+            }
+        }
+        if (pending.valid()) {
+            // 在锁外等待正在进行的相同计算
+            return pending.get();
+        }
+        return run_compute(shard, key, *promise, std::forward<F>(compute));
+    }
+
+    // 异步接口: 在线程池上执行compute, 返回shared_future; 命中时返回已就绪的future, 不占用工作线程
+    template<typename F>
+    std::shared_future<ValuePtr> submit(ThreadPool& pool, const std::string& model_id,
+                                        const void* data, std::size_t size, F&& compute) {
+        const Key key = make_key(model_id, data, size);
+        Shard& shard = shard_of(key);
+        std::shared_ptr<std::promise<ValuePtr>> promise;
+        std::shared_future<ValuePtr> future;
+        {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            if (auto value = probe_locked(shard, key, future)) {
+                std::promise<ValuePtr> ready;
+                ready.set_value(std::move(value));
+                return ready.get_future().share();
+            }
+            if (future.valid()) {
+                return future;
+            }
+            promise = begin_compute_locked(shard, key);
+            future = shard.inflight.at(key).future;
+        }
+
+        try {
+            pool.enqueue([this, &shard, key, promise, compute = std::forward<F>(compute)]() mutable {
+                try {
+                    run_compute(shard, key, *promise, compute);
+                } catch (...) {
+                    // 异常已经通过promise传给等待者
+                }
+            });
+        } catch (...) {
+            // 线程池已停止: 撤销in-flight登记并把异常传给等待者
+            fail_compute(shard, key, *promise, std::current_exception());
+            throw;
+        }
+        return future;
+    }
+
+#if defined(__cpp_impl_coroutine)
+    // 协程接口, 用于co_await的 预处理->推理->后处理 链, compute返回Task<Value>
+    // 命中时直接返回, 不挂起也不切换线程; 未命中时切换到线程池上执行compute;
+    // 相同请求正在计算时挂起, 计算结束后在线程池上恢复. data在任务完成前必须保持有效
+    template<typename F>
+    Task<ValuePtr> co_get_or_compute(ThreadPool& pool, std::string model_id,
+                                     const void* data, std::size_t size, F compute) {
+        const Key key = make_key(model_id, data, size);
+        Shard& shard = shard_of(key);
+        std::shared_ptr<std::promise<ValuePtr>> promise;
+        std::shared_future<ValuePtr> pending;
+        ValuePtr value;
+        {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            value = probe_locked(shard, key, pending);
+            if (!value && !pending.valid()) {
+                promise = begin_compute_locked(shard, key);
+            }
+        }
+        if (value) {
+            co_return value;
+        }
+        if (pending.valid()) {
+            co_await InFlightAwaiter{shard, key, pool, pending};
+            co_return pending.get();
+        }
+
+        std::exception_ptr error;
+        try {
+            co_await ThreadPoolExecutor(pool).schedule();
+            value = std::make_shared<const Value>(co_await compute());
+        } catch (...) {
+            error = std::current_exception();
+        }
+        if (error) {
+            fail_compute(shard, key, *promise, error);
+            std::rethrow_exception(error);
+        }
+        finish_compute(shard, key, *promise, value);
+        co_return value;
+    }
+#endif
+
+    // 清空所有结果(不影响正在计算的请求)
+    void clear() {
+        for (auto& shard : _shards) {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            shard.ring.clear();
+            shard.index.clear();
+            shard.hand = shard.ring.end();
+            shard.bytes = 0;
+        }
+    }
+
+    ResultCacheStats stats() const {
+        ResultCacheStats s;
+        s.hits = _hits.load(std::memory_order_relaxed);
+        s.misses = _misses.load(std::memory_order_relaxed);
+        s.inflight_hits = _inflight_hits.load(std::memory_order_relaxed);
+        s.evictions = _evictions.load(std::memory_order_relaxed);
+        s.expirations = _expirations.load(std::memory_order_relaxed);
+        for (const auto& shard : _shards) {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            s.entries += shard.index.size();
+            s.bytes += shard.bytes;
+        }
+        return s;
+    }
+
+private:
+    struct Key {
+        std::string model_id;
+        uint64_t hash;
+        std::size_t size;
+
+        bool operator==(const Key& other) const {
+            return hash == other.hash && size == other.size && model_id == other.model_id;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const noexcept {
+            return static_cast<std::size_t>(key.hash ^ (std::hash<std::string>()(key.model_id) * 0x9E3779B97F4A7C15ull));
+        }
+    };
+
+    struct Entry {
+        Key key;
+        ValuePtr value;
+        std::size_t cost;
+        Clock::time_point expire;
+        // CLOCK访问位
+        bool referenced;
+    };
+
+    // 正在计算的请求: 同步等待者通过future等待, 协程等待者登记在waiters中, 由计算方在结束时唤醒
+    struct InFlight {
+        std::shared_future<ValuePtr> future;
+        std::vector<std::function<void()>> waiters;
+    };
+
+    struct Shard {
+        mutable std::mutex mtx;
+        // CLOCK环, hand指向下一个淘汰候选
+        std::list<Entry> ring;
+        typename std::list<Entry>::iterator hand = ring.end();
+        std::unordered_map<Key, typename std::list<Entry>::iterator, KeyHash> index;
+        std::unordered_map<Key, InFlight, KeyHash> inflight;
+        std::size_t bytes = 0;
+    };
+
+    Key make_key(const std::string& model_id, const void* data, std::size_t size) const {
+        return Key{model_id, xxhash64(data, size), size};
+    }
+
+    Shard& shard_of(const Key& key) {
+        return _shards[KeyHash()(key) % _shards.size()];
+    }
+
+    bool expired(const Entry& entry, Clock::time_point now) const {
+        return _config.ttl.count() > 0 && now >= entry.expire;
+    }
+
+    void erase_locked(Shard& shard, typename std::list<Entry>::iterator it) {
+        if (shard.hand == it) {
+            ++shard.hand;
+        }
+        shard.bytes -= it->cost;
+        shard.index.erase(it->key);
+        shard.ring.erase(it);
+    }
+
+    ValuePtr lookup_locked(Shard& shard, const Key& key) {
+        auto found = shard.index.find(key);
+        if (found == shard.index.end()) {
+            return nullptr;
+        }
+        auto it = found->second;
+        if (expired(*it, Clock::now())) {
+            erase_locked(shard, it);
+            _expirations.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        it->referenced = true;
+        return it->value;
+    }
+
+    // 查缓存和in-flight表, 并统计命中情况
+    ValuePtr probe_locked(Shard& shard, const Key& key, std::shared_future<ValuePtr>& pending) {
+        if (auto value = lookup_locked(shard, key)) {
+            _hits.fetch_add(1, std::memory_order_relaxed);
+            return value;
+        }
+        auto it = shard.inflight.find(key);
+        if (it != shard.inflight.end()) {
+            _inflight_hits.fetch_add(1, std::memory_order_relaxed);
+            pending = it->second.future;
+            return nullptr;
+        }
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    std::shared_ptr<std::promise<ValuePtr>> begin_compute_locked(Shard& shard, const Key& key) {
+        auto promise = std::make_shared<std::promise<ValuePtr>>();
+        shard.inflight.emplace(key, InFlight{promise->get_future().share(), {}});
+        return promise;
+    }
+
+    template<typename F>
+    ValuePtr run_compute(Shard& shard, const Key& key, std::promise<ValuePtr>& promise, F&& compute) {
+        ValuePtr value;
+        try {
+            value = std::make_shared<const Value>(compute());
+        } catch (...) {
+            fail_compute(shard, key, promise, std::current_exception());
+            throw;
+        }
+        finish_compute(shard, key, promise, value);
+        return value;
+    }
+
+    // promise在锁内设置: 只要in-flight登记还在, 对应的future就一定未就绪
+    void finish_compute(Shard& shard, const Key& key, std::promise<ValuePtr>& promise, const ValuePtr& value) {
+        std::vector<std::function<void()>> waiters;
+        {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            insert_locked(shard, key, value);
+            waiters = take_inflight_locked(shard, key);
+            promise.set_value(value);
+        }
+        for (auto& wake : waiters) {
+            wake();
+        }
+    }
+
+    void fail_compute(Shard& shard, const Key& key, std::promise<ValuePtr>& promise, std::exception_ptr error) {
+        std::vector<std::function<void()>> waiters;
+        {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            waiters = take_inflight_locked(shard, key);
+            promise.set_exception(error);
+        }
+        for (auto& wake : waiters) {
+            wake();
+        }
+    }
+
+    std::vector<std::function<void()>> take_inflight_locked(Shard& shard, const Key& key) {
+        auto it = shard.inflight.find(key);
+        std::vector<std::function<void()>> waiters = std::move(it->second.waiters);
+        shard.inflight.erase(it);
+        return waiters;
+    }
+
+#if defined(__cpp_impl_coroutine)
+    // 挂起直到正在进行的相同计算结束, 然后在线程池上恢复; 不阻塞任何线程
+    struct InFlightAwaiter {
+        Shard& shard;
+        const Key& key;
+        ThreadPool& pool;
+        const std::shared_future<ValuePtr>& pending;
+
+        bool await_ready() const {
+            return pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            if (await_ready()) {
+                return false;
+            }
+            ThreadPool* p = &pool;
+            shard.inflight.at(key).waiters.emplace_back([p, handle]() {
+                try {
+                    p->enqueue([handle]() { handle.resume(); });
+                } catch (...) {
+                    // 线程池已停止: 在唤醒方线程上恢复
+                    handle.resume();
+                }
+            });
+            return true;
+        }
+
+        void await_resume() const noexcept {}
+    };
+#endif
+
+    void insert_locked(Shard& shard, const Key& key, ValuePtr value) {
+        auto found = shard.index.find(key);
+        if (found != shard.index.end()) {
+            erase_locked(shard, found->second);
+        }
+        const std::size_t cost = _cost(*value);
+        if (cost > _shard_capacity) {
+            // 单个结果超过分片容量, 不缓存
+            return;
+        }
+        while (shard.bytes + cost > _shard_capacity) {
+            evict_one_locked(shard);
+        }
+        // 插在hand之前, 新条目最后被扫描到
+        auto it = shard.ring.insert(shard.hand,
+            Entry{key, std::move(value), cost, Clock::now() + _config.ttl, false});
+        shard.index.emplace(key, it);
+        shard.bytes += cost;
+    }
+
+    // CLOCK淘汰: 跳过并清除访问位为1的条目, 淘汰第一个访问位为0的条目; 过期条目直接淘汰
+    void evict_one_locked(Shard& shard) {
+        const auto now = Clock::now();
+        while (true) {
+            if (shard.hand == shard.ring.end()) {
+                shard.hand = shard.ring.begin();
+            }
+            auto it = shard.hand;
+            if (it->referenced && !expired(*it, now)) {
+                it->referenced = false;
+                ++shard.hand;
+                continue;
+            }
+            if (expired(*it, now)) {
+                _expirations.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                _evictions.fetch_add(1, std::memory_order_relaxed);
+            }
+            erase_locked(shard, it);
+            return;
+        }
+    }
+
+private:
+    ResultCacheConfig _config;
+    CostFunc _cost;
+    std::vector<Shard> _shards;
+    std::size_t _shard_capacity;
+    std::atomic<std::size_t> _hits{0};
+    std::atomic<std::size_t> _misses{0};
+    std::atomic<std::size_t> _inflight_hits{0};
+    std::atomic<std::size_t> _evictions{0};
+    std::atomic<std::size_t> _expirations{0};
+};
@@ -78,6 +78,17 @@ public:
         return _workers.size();
     }
 
+    // 判断调用线程是否为本线程池的工作线程(工作线程中阻塞等待本池的任务可能死锁)
+    bool is_worker_thread() const {
+        const std::thread::id id = std::this_thread::get_id();
+        for (const auto& worker : _workers) {
+            if (worker.get_id() == id) {
+                return true;
+            }
+        }
+        return false;
+    }
+
 private:
     // 创建指定数量的工作线程
     void create_worker_threads(size_t thread_num) {
@@ -0,0 +1,323 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <future>
+#include <exception>
+#include <algorithm>
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define POSTPROCESS_USE_AVX2 1
+#endif
+
+#include "src/core/thread_pool.hpp"
+#include "src/kernel/shape.hpp"
+
+// 分类模型后处理算子: softmax / argmax / top-k, 以及基于ThreadPool的批量版本
+// 输入均为行主序的logits, 单行长度为n(如ImageNet的1000类)
+namespace postprocess {
+
+// top-k结果: 分数和类别下标
+struct ScoreIndex {
+    float score;
+    std::size_t index;
+};
+
+// 默认top-k数量(与常见的top-5精度评估一致)
+static constexpr std::size_t DEFAULT_TOPK = 5;
+
+namespace detail {
+
+#if POSTPROCESS_USE_AVX2
+// 8路float水平求最大值
+inline float hmax256(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    lo = _mm_max_ps(lo, hi);
+    lo = _mm_max_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_max_ss(lo, _mm_shuffle_ps(lo, lo, 0x1));
+    return _mm_cvtss_f32(lo);
+}
+
+// 8路float水平求和
+inline float hsum256(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    lo = _mm_add_ps(lo, hi);
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 0x1));
+    return _mm_cvtss_f32(lo);
+}
+
+// 8路exp近似(Cephes多项式): exp(x) = 2^n * p(r), r = x - n*ln2, 相对误差约1e-7
+inline __m256 exp256(__m256 x) {
+    const __m256 exp_hi = _mm256_set1_ps(88.3762626647949f);
+    const __m256 exp_lo = _mm256_set1_ps(-88.3762626647949f);
+    const __m256 log2e = _mm256_set1_ps(1.44269504088896341f);
+    // ln2拆成高低两部分, 减少r的舍入误差
+    const __m256 ln2_hi = _mm256_set1_ps(0.693359375f);
+    const __m256 ln2_lo = _mm256_set1_ps(-2.12194440e-4f);
+
+    x = _mm256_min_ps(x, exp_hi);
+    x = _mm256_max_ps(x, exp_lo);
+
+    // n = floor(x * log2e + 0.5)
+    __m256 fx = _mm256_fmadd_ps(x, log2e, _mm256_set1_ps(0.5f));
+    fx = _mm256_floor_ps(fx);
+    x = _mm256_fnmadd_ps(fx, ln2_hi, x);
+    x = _mm256_fnmadd_ps(fx, ln2_lo, x);
+
+    __m256 y = _mm256_set1_ps(1.9875691500e-4f);
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.3981999507e-3f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(8.3334519073e-3f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(4.1665795894e-2f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.6666665459e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(5.0000001201e-1f));
+    __m256 x2 = _mm256_mul_ps(x, x);
+    y = _mm256_fmadd_ps(y, x2, _mm256_add_ps(x, _mm256_set1_ps(1.0f)));
+
+    // 2^n: 直接构造float的指数位
+    __m256i n = _mm256_cvttps_epi32(fx);
+    n = _mm256_add_epi32(n, _mm256_set1_epi32(127));
+    n = _mm256_slli_epi32(n, 23);
+    return _mm256_mul_ps(y, _mm256_castsi256_ps(n));
+}
+#endif
+
+// 将候选值插入按分数降序排列的top-k数组, 同分时下标小的在前
+inline void insert_sorted(ScoreIndex* out, std::size_t& count, std::size_t k,
+                          float score, std::size_t index) {
+    std::size_t pos = count < k ? count : k - 1;
+    // 从尾部向前移动, 找到插入位置(严格大于才前移, 保证同分时先出现的下标靠前)
+    while (pos > 0 && out[pos - 1].score < score) {
+        if (pos < k) {
+            out[pos] = out[pos - 1];
+        }
+        --pos;
+    }
+    out[pos] = ScoreIndex{score, index};
+    if (count < k) {
+        ++count;
+    }
+}
+
+// 将rows行数据切分给线程池并行处理, 调用线程阻塞等待所有分片完成
+// 调用方本身是pool的工作线程时(如协程链中的后处理阶段)直接在当前线程串行执行, 避免等待本池任务而死锁
+template<typename RowFn>
+void parallel_rows(ThreadPool& pool, std::size_t rows, RowFn&& fn) {
+    if (rows == 0) {
+        return;
+    }
+    if (pool.is_worker_thread()) {
+        for (std::size_t r = 0; r < rows; ++r) {
+            fn(r);
+        }
+        return;
+    }
+    const std::size_t parts = std::min(rows, std::max<std::size_t>(1, pool.thread_count()));
+    const std::size_t step = (rows + parts - 1) / parts;
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(parts);
+    // 分片按引用捕获fn, 必须等所有已提交的分片结束后才能返回或抛出异常
+    std::exception_ptr error;
+    try {
+        for (std::size_t begin = 0; begin < rows; begin += step) {
+            const std::size_t end = std::min(rows, begin + step);
+            futures.emplace_back(pool.enqueue([&fn, begin, end]() {
+                for (std::size_t r = begin; r < end; ++r) {
+                    fn(r);
+                }
+            }));
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (auto& f : futures) {
+        try {
+            f.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// 求最大值(n必须大于0), SizeT为std::size_t或编译期常量Dim<N>
+template<typename SizeT>
+inline float max_reduce_impl(const float* x, SizeT n) {
+    std::size_t i = 0;
+    float m = -std::numeric_limits<float>::infinity();
+#if POSTPROCESS_USE_AVX2
+    const std::size_t n8 = n & ~static_cast<std::size_t>(7);
+    if (n8 > 0) {
+        __m256 vm = _mm256_loadu_ps(x);
+        for (i = 8; i < n8; i += 8) {
+            vm = _mm256_max_ps(vm, _mm256_loadu_ps(x + i));
+        }
+        m = hmax256(vm);
+    }
+#endif
+    for (; i < n; ++i) {
+        m = x[i] > m ? x[i] : m;
+    }
+    return m;
+}
+
+// 数值稳定的softmax实现, SizeT同上
+template<typename SizeT>
+inline void softmax_impl(const float* in, float* out, SizeT n) {
+    const float m = max_reduce_impl(in, n);
+    std::size_t i = 0;
+    float sum = 0.0f;
+#if POSTPROCESS_USE_AVX2
+    const std::size_t n8 = n & ~static_cast<std::size_t>(7);
+    const __m256 vm = _mm256_set1_ps(m);
+    __m256 vsum = _mm256_setzero_ps();
+    for (; i < n8; i += 8) {
+        __m256 e = exp256(_mm256_sub_ps(_mm256_loadu_ps(in + i), vm));
+        _mm256_storeu_ps(out + i, e);
+        vsum = _mm256_add_ps(vsum, e);
+    }
+    sum = hsum256(vsum);
+#endif
+    for (; i < n; ++i) {
+        out[i] = std::exp(in[i] - m);
+        sum += out[i];
+    }
+
+    const float inv = 1.0f / sum;
+    i = 0;
+#if POSTPROCESS_USE_AVX2
+    const __m256 vinv = _mm256_set1_ps(inv);
+    for (; i < n8; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(out + i), vinv));
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] *= inv;
+    }
+}
+
+} // namespace detail
+
+// 求最大值(n必须大于0)
+inline float max_reduce(const float* x, std::size_t n) {
+    return detail::max_reduce_impl(x, n);
+}
+
+// 求最大值的下标, 有多个最大值时返回第一个(与np.argmax一致)
+inline std::size_t argmax(const float* x, std::size_t n) {
+    if (n == 0) {
+        throw std::invalid_argument("argmax on empty input");
+    }
+    // 先向量化求最大值, 再线性查找第一个等于最大值的位置
+    const float m = max_reduce(x, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (x[i] == m) {
+            return i;
+        }
+    }
+    // 全为NaN时退化为0
+    return 0;
+}
+
+// 数值稳定的softmax: out[i] = exp(x[i] - max) / sum, in和out可以是同一块内存
+// 通用版本, 循环边界在运行时确定
+inline void softmax_generic(const float* in, float* out, std::size_t n) {
+    if (n == 0) {
+        return;
+    }
+    detail::softmax_impl(in, out, n);
+}
+
+// 形状特化版本: N在编译期确定, 向量化主循环和尾部处理都按常量展开
+template<std::size_t N>
+inline void softmax_fixed(const float* in, float* out) {
+    static_assert(N > 0, "softmax_fixed requires N > 0");
+    detail::softmax_impl(in, out, Dim<N>{});
+}
+
+// 默认入口走通用版本: 实测N=1000时特化版本与通用版本性能相当(在噪声范围内), 不做形状分发
+inline void softmax(const float* in, float* out, std::size_t n) {
+    softmax_generic(in, out, n);
+}
+
+// 部分选择的top-k: 维护一个大小为k的有序数组, 不做全量排序, 复杂度O(n + m*k)(m为实际插入次数)
+// 结果按分数降序写入out[0..k), 同分时下标小的在前
+inline void topk(const float* x, std::size_t n, std::size_t k, ScoreIndex* out) {
+    if (k == 0) {
+        return;
+    }
+    if (k > n) {
+        throw std::invalid_argument("topk: k is larger than input size");
+    }
+
+    std::size_t count = 0;
+    // 前k个元素直接插入
+    std::size_t i = 0;
+    for (; i < k; ++i) {
+        detail::insert_sorted(out, count, k, x[i], i);
+    }
+
+#if POSTPROCESS_USE_AVX2
+    // 每8个元素与当前第k大的阈值比较, 整块都不超过阈值时直接跳过
+    for (; i + 8 <= n; i += 8) {
+        const __m256 v = _mm256_loadu_ps(x + i);
+        int mask = _mm256_movemask_ps(
+            _mm256_cmp_ps(v, _mm256_set1_ps(out[k - 1].score), _CMP_GT_OQ));
+        while (mask != 0) {
+            const int lane = __builtin_ctz(static_cast<unsigned>(mask));
+            mask &= mask - 1;
+            const float s = x[i + lane];
+            // 阈值在块内可能已经被抬高, 需要重新判断
+            if (s > out[k - 1].score) {
+                detail::insert_sorted(out, count, k, s, i + lane);
+            }
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (x[i] > out[k - 1].score) {
+            detail::insert_sorted(out, count, k, x[i], i);
+        }
+    }
+}
+
+// 批量接口可以在pool的工作线程中调用, 此时不再切分而是在当前线程串行处理
+
+// 批量softmax: in/out为batch x n的行主序矩阵
+inline void softmax_batch(ThreadPool& pool, const float* in, float* out,
+                          std::size_t batch, std::size_t n) {
+    detail::parallel_rows(pool, batch, [=](std::size_t r) {
+        softmax(in + r * n, out + r * n, n);
+    });
+}
+
+// 批量argmax: out长度为batch
+inline void argmax_batch(ThreadPool& pool, const float* in, std::size_t* out,
+                         std::size_t batch, std::size_t n) {
+    detail::parallel_rows(pool, batch, [=](std::size_t r) {
+        out[r] = argmax(in + r * n, n);
+    });
+}
+
+// 批量top-k: out为batch x k的行主序矩阵
+inline void topk_batch(ThreadPool& pool, const float* in, ScoreIndex* out,
+                       std::size_t batch, std::size_t n, std::size_t k = DEFAULT_TOPK) {
+    if (k > n) {
+        throw std::invalid_argument("topk_batch: k is larger than input size");
+    }
+    detail::parallel_rows(pool, batch, [=](std::size_t r) {
+        topk(in + r * n, n, k, out + r * k);
+    });
+}
+
+} // namespace postprocess
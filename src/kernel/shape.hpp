@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+
+// 编译期维度: 算子的实现按维度类型模板化, 传入std::size_t为通用版本, 传入Dim<N>为形状特化版本
+// 特化版本的循环边界, 分块尾部和缓冲区大小都在编译期确定, 编译器可以完全展开/向量化
+template<std::size_t N>
+using Dim = std::integral_constant<std::size_t, N>;
+
+template<typename D>
+struct IsStaticDim : std::false_type {};
+
+template<std::size_t N>
+struct IsStaticDim<Dim<N>> : std::true_type {};
+
+template<typename... Ds>
+inline constexpr bool all_static_dims_v = (IsStaticDim<Ds>::value && ...);
+
+// ResNet50静态引擎的固定形状(与script/engine_inference.py和export_resnet50.py一致)
+namespace resnet50 {
+// 输入 (1, 3, 224, 224)
+static constexpr std::size_t INPUT_C = 3;
+static constexpr std::size_t INPUT_H = 224;
+static constexpr std::size_t INPUT_W = 224;
+// 预处理先缩放到256x256再中心裁剪
+static constexpr std::size_t RESIZE_H = 256;
+static constexpr std::size_t RESIZE_W = 256;
+// 输出 (1, 1000)
+static constexpr std::size_t NUM_CLASSES = 1000;
+// 全局池化后的特征维度(fc层输入)
+static constexpr std::size_t FEATURE_DIM = 2048;
+// layer1 bottleneck中1x1卷积的空间尺寸 56x56
+static constexpr std::size_t LAYER1_HW = 56 * 56;
+} // namespace resnet50
@@ -0,0 +1,215 @@
+#include "src/core/coro_task.hpp"
+#include "src/core/thread_pool.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+#include <atomic>
+#include <future>
+
+// Simulated pipeline stages: each stage hops onto a pool worker before running
+Task<std::vector<float>> preprocess(ThreadPoolExecutor ex, int frame_id) {
+    co_await ex.schedule();
+    co_return std::vector<float>(8, static_cast<float>(frame_id));
+}
+
+Task<float> inference(ThreadPoolExecutor ex, std::vector<float> input) {
+    co_await ex.schedule();
+    float sum = 0.0f;
+    for (float v : input) sum += v;
+    co_return sum;
+}
+
+Task<std::string> postprocess(ThreadPoolExecutor ex, float logit) {
+    co_await ex.schedule();
+    co_return "score=" + std::to_string(static_cast<int>(logit));
+}
+
+Task<std::string> run_request(ThreadPoolExecutor ex, int frame_id) {
+    auto input = co_await preprocess(ex, frame_id);
+    auto logit = co_await inference(ex, std::move(input));
+    co_return co_await postprocess(ex, logit);
+}
+
+// Test 1: multi-stage co_await chain resumes on pool workers and returns the final result
+void test_pipeline_chain(ThreadPool& pool) {
+    std::cout << "=== Test 1: Preprocess -> Inference -> Postprocess Chain ===" << std::endl;
+    ThreadPoolExecutor ex(pool);
+    const auto main_id = std::this_thread::get_id();
+
+    auto check_thread = [](ThreadPoolExecutor ex, std::thread::id main_id) -> Task<bool> {
+        co_await ex.schedule();
+        co_return std::this_thread::get_id() != main_id;
+    };
+    const bool on_worker = sync_wait(check_thread(ex, main_id));
+    assert(on_worker && "Test 1 Failed: task did not resume on a pool worker");
+
+    std::string res = sync_wait(run_request(ex, 3));
+    assert(res == "score=24" && "Test 1 Failed: incorrect pipeline result");
+    std::cout << "Test 1 Succeeded: " << res << std::endl << std::endl;
+}
+
+// Test 2: fan-out with when_all on a single worker; a future.get() based version would deadlock here
+void test_when_all_single_worker() {
+    std::cout << "=== Test 2: when_all Fan-Out On A Single Worker ===" << std::endl;
+    ThreadPool pool(1);
+    ThreadPoolExecutor ex(pool);
+
+    auto batch = [](ThreadPoolExecutor ex, int count) -> Task<std::vector<std::string>> {
+        co_await ex.schedule();
+        std::vector<Task<std::string>> requests;
+        for (int i = 0; i < count; ++i) {
+            requests.emplace_back(run_request(ex, i));
+        }
+        co_return co_await when_all(std::move(requests));
+    };
+
+    auto results = sync_wait(batch(ex, 64));
+    assert(results.size() == 64 && "Test 2 Failed: incorrect result count");
+    for (int i = 0; i < 64; ++i) {
+        assert(results[i] == "score=" + std::to_string(i * 8) && "Test 2 Failed: results out of order");
+    }
+    std::cout << "Test 2 Succeeded: " << results.size() << " requests completed" << std::endl << std::endl;
+}
+
+// Test 3: when_all over void tasks and over tasks that complete synchronously
+void test_when_all_void(ThreadPool& pool) {
+    std::cout << "=== Test 3: when_all With Void And Synchronous Tasks ===" << std::endl;
+    ThreadPoolExecutor ex(pool);
+    std::atomic<int> count{0};
+
+    auto work = [](ThreadPoolExecutor ex, std::atomic<int>& count) -> Task<void> {
+        co_await ex.schedule();
+        count.fetch_add(1);
+    };
+    std::vector<Task<void>> tasks;
+    for (int i = 0; i < 100; ++i) {
+        tasks.emplace_back(work(ex, count));
+    }
+    sync_wait(when_all(std::move(tasks)));
+    assert(count.load() == 100 && "Test 3 Failed: not all void tasks executed");
+
+    // No schedule(): every child finishes inline inside when_all
+    auto value = [](int v) -> Task<int> { co_return v; };
+    std::vector<Task<int>> inline_tasks;
+    for (int i = 0; i < 10; ++i) {
+        inline_tasks.emplace_back(value(i));
+    }
+    auto values = sync_wait(when_all(std::move(inline_tasks)));
+    for (int i = 0; i < 10; ++i) {
+        assert(values[i] == i && "Test 3 Failed: incorrect synchronous result");
+    }
+    const auto empty_results = sync_wait(when_all(std::vector<Task<int>>{}));
+    assert(empty_results.empty() && "Test 3 Failed: empty when_all");
+    std::cout << "Test 3 Succeeded" << std::endl << std::endl;
+}
+
+// Test 4: exceptions propagate through co_await and when_all
+void test_exception(ThreadPool& pool) {
+    std::cout << "=== Test 4: Exception Propagation ===" << std::endl;
+    ThreadPoolExecutor ex(pool);
+
+    auto fail = [](ThreadPoolExecutor ex, int i) -> Task<int> {
+        co_await ex.schedule();
+        if (i == 5) {
+            throw std::runtime_error("inference failed");
+        }
+        co_return i;
+    };
+
+    bool catch_exception = false;
+    try {
+        sync_wait(fail(ex, 5));
+    } catch (const std::runtime_error&) {
+        catch_exception = true;
+    }
+    assert(catch_exception && "Test 4 Failed: exception not propagated from task");
+
+    std::vector<Task<int>> tasks;
+    for (int i = 0; i < 10; ++i) {
+        tasks.emplace_back(fail(ex, i));
+    }
+    catch_exception = false;
+    try {
+        sync_wait(when_all(std::move(tasks)));
+    } catch (const std::runtime_error& e) {
+        catch_exception = true;
+        std::cout << "Expected exception caught: " << e.what() << std::endl;
+    }
+    assert(catch_exception && "Test 4 Failed: exception not propagated from when_all");
+
+    // co_await on an empty (moved-from) Task throws instead of touching a null handle
+    Task<int> moved = fail(ex, 1);
+    Task<int> owner = std::move(moved);
+    catch_exception = false;
+    try {
+        sync_wait(std::move(moved));
+    } catch (const std::logic_error&) {
+        catch_exception = true;
+    }
+    assert(catch_exception && "Test 4 Failed: awaiting an empty task should throw");
+    std::cout << "Test 4 Succeeded" << std::endl << std::endl;
+}
+
+// Benchmark: fan-out of requests with blocking futures vs co_await chains
+void bench(ThreadPool& pool) {
+    std::cout << "=== Benchmark: 1000 Three-Stage Requests ===" << std::endl;
+    ThreadPoolExecutor ex(pool);
+    const int count = 1000;
+    // Outer tasks block workers in get(), so at least one worker must stay free or the pool deadlocks
+    const std::size_t in_flight = pool.thread_count() - 1;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<std::string>> futures;
+    for (int i = 0; i < count; ++i) {
+        // Each request blocks one worker in get() while its stages wait in the queue
+        futures.emplace_back(pool.enqueue([&pool, i]() {
+            auto input = pool.enqueue([i]() { return std::vector<float>(8, static_cast<float>(i)); }).get();
+            auto logit = pool.enqueue([&input]() {
+                float sum = 0.0f;
+                for (float v : input) sum += v;
+                return sum;
+            }).get();
+            return "score=" + std::to_string(static_cast<int>(logit));
+        }));
+        if (futures.size() == in_flight) {
+            for (auto& f : futures) f.get();
+            futures.clear();
+        }
+    }
+    for (auto& f : futures) f.get();
+    auto mid = std::chrono::steady_clock::now();
+
+    std::vector<Task<std::string>> requests;
+    for (int i = 0; i < count; ++i) {
+        requests.emplace_back(run_request(ex, i));
+    }
+    sync_wait(when_all(std::move(requests)));
+    auto stop = std::chrono::steady_clock::now();
+
+    using ms = std::chrono::duration<double, std::milli>;
+    std::cout << "  blocking futures: " << ms(mid - start).count() << " ms" << std::endl;
+    std::cout << "  co_await chains:  " << ms(stop - mid).count() << " ms" << std::endl;
+}
+
+int main() {
+    try {
+        ThreadPool pool(4);
+        test_pipeline_chain(pool);
+        test_when_all_single_worker();
+        test_when_all_void(pool);
+        test_exception(pool);
+        bench(pool);
+
+        std::cout << "=============================================" << std::endl;
+        std::cout << "✅ All test cases executed successfully!" << std::endl;
+        std::cout << "=============================================" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Uncaught exception during testing: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,359 @@
+#include "src/core/kv_cache.hpp"
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <random>
+#include <cassert>
+#include <algorithm>
+#include <stdexcept>
+
+using Cache = PagedKVCache<float>;
+
+static KVCacheConfig small_config(std::size_t num_blocks, std::size_t num_swap_blocks) {
+    KVCacheConfig config;
+    config.num_layers = 2;
+    config.num_kv_heads = 2;
+    config.head_dim = 4;
+    config.block_tokens = 4;
+    config.num_blocks = num_blocks;
+    config.num_swap_blocks = num_swap_blocks;
+    return config;
+}
+
+static std::vector<int32_t> make_tokens(int32_t first, std::size_t count) {
+    std::vector<int32_t> tokens(count);
+    for (std::size_t i = 0; i < count; ++i) tokens[i] = first + static_cast<int32_t>(i);
+    return tokens;
+}
+
+// KV content is a pure function of (layer, token, position), so shared prefix blocks hold identical data
+static void write_token(Cache& cache, const KVSlot& slot, int32_t token, std::size_t pos) {
+    const std::size_t elems = cache.config().num_kv_heads * cache.config().head_dim;
+    std::vector<float> k(elems), v(elems);
+    for (std::size_t layer = 0; layer < cache.config().num_layers; ++layer) {
+        std::fill(k.begin(), k.end(), static_cast<float>(token));
+        std::fill(v.begin(), v.end(), static_cast<float>(pos));
+        k[0] += static_cast<float>(layer);
+        cache.write(layer, slot, k.data(), v.data());
+    }
+}
+
+static void write_prompt(Cache& cache, int64_t seq_id, const std::vector<int32_t>& prompt, std::size_t from) {
+    for (std::size_t pos = from; pos < prompt.size(); ++pos) {
+        write_token(cache, cache.slot(seq_id, pos), prompt[pos], pos);
+    }
+    cache.mark_computed(seq_id, prompt.size());
+}
+
+static bool check_sequence(Cache& cache, int64_t seq_id, const std::vector<int32_t>& tokens) {
+    const std::size_t elems = cache.config().num_kv_heads * cache.config().head_dim;
+    for (std::size_t pos = 0; pos < tokens.size(); ++pos) {
+        KVSlot slot = cache.slot(seq_id, pos);
+        for (std::size_t layer = 0; layer < cache.config().num_layers; ++layer) {
+            const float* k = cache.key_data(layer, slot.block) + slot.offset * elems;
+            const float* v = cache.value_data(layer, slot.block) + slot.offset * elems;
+            if (k[0] != static_cast<float>(tokens[pos]) + static_cast<float>(layer) ||
+                k[1] != static_cast<float>(tokens[pos]) || v[0] != static_cast<float>(pos)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Test 1: sequences with a common prefix share full blocks
+void test_prefix_sharing() {
+    std::cout << "=== Test 1: Prefix Block Sharing ===" << std::endl;
+    Cache cache(small_config(16, 0));
+    auto a = make_tokens(100, 10);
+    [[maybe_unused]] const std::size_t hit_a = cache.add_sequence(1, a);
+    assert(hit_a == 0 && "Test 1 Failed: unexpected hit on empty cache");
+    write_prompt(cache, 1, a, 0);
+
+    auto b = make_tokens(100, 8);
+    b.push_back(7);
+    b.push_back(8);
+    [[maybe_unused]] const std::size_t hit_b = cache.add_sequence(2, b);
+    assert(hit_b == 8 && "Test 1 Failed: expected 2 shared blocks");
+    write_prompt(cache, 2, b, 8);
+
+    [[maybe_unused]] const auto& ta = cache.block_table(1);
+    [[maybe_unused]] const auto& tb = cache.block_table(2);
+    assert(ta[0] == tb[0] && ta[1] == tb[1] && ta[2] != tb[2] && "Test 1 Failed: block tables not shared");
+    assert(cache.ref_count(ta[0]) == 2 && "Test 1 Failed: shared block ref count");
+    assert(cache.stats().used_blocks == 4 && "Test 1 Failed: used block count");
+    assert(check_sequence(cache, 1, a) && check_sequence(cache, 2, b) && "Test 1 Failed: KV data mismatch");
+    std::cout << "Test 1 Succeeded" << std::endl << std::endl;
+}
+
+// Test 2: fork shares every block, the first append to a shared tail block copies it
+void test_fork_copy_on_write() {
+    std::cout << "=== Test 2: Fork And Copy-On-Write ===" << std::endl;
+    Cache cache(small_config(16, 0));
+    auto a = make_tokens(0, 6);
+    cache.add_sequence(1, a);
+    write_prompt(cache, 1, a, 0);
+    cache.fork(1, 2);
+    [[maybe_unused]] const int32_t tail = cache.block_table(1).back();
+    assert(cache.ref_count(tail) == 2 && "Test 2 Failed: fork did not share tail");
+
+    auto b = a;
+    b.push_back(50);
+    KVSlot slot = cache.append_token(2, 50);
+    write_token(cache, slot, 50, 6);
+    assert(slot.block != tail && cache.ref_count(tail) == 1 && "Test 2 Failed: no copy-on-write");
+    assert(cache.block_table(1)[0] == cache.block_table(2)[0] && "Test 2 Failed: full block should stay shared");
+
+    a.push_back(60);
+    slot = cache.append_token(1, 60);
+    write_token(cache, slot, 60, 6);
+    assert(slot.block == tail && "Test 2 Failed: unshared tail should be written in place");
+    assert(check_sequence(cache, 1, a) && check_sequence(cache, 2, b) && "Test 2 Failed: KV data mismatch");
+    assert(cache.stats().cow_copies == 1 && "Test 2 Failed: cow count");
+    std::cout << "Test 2 Succeeded" << std::endl << std::endl;
+}
+
+// Test 3: freed prefix blocks stay cached until evicted under pressure
+void test_cached_reuse_and_eviction() {
+    std::cout << "=== Test 3: Cached Prefix Reuse And LRU Eviction ===" << std::endl;
+    Cache cache(small_config(4, 0));
+    auto a = make_tokens(0, 8);
+    cache.add_sequence(1, a);
+    write_prompt(cache, 1, a, 0);
+    cache.free_sequence(1);
+    assert(cache.stats().cached_blocks == 2 && "Test 3 Failed: freed blocks not cached");
+
+    [[maybe_unused]] const std::size_t hit_reuse = cache.add_sequence(2, a);
+    assert(hit_reuse == 8 && "Test 3 Failed: cached prefix not reused");
+    assert(check_sequence(cache, 2, a) && "Test 3 Failed: cached KV data mismatch");
+    cache.free_sequence(2);
+
+    // Needs all 4 blocks: both cached blocks must be evicted
+    auto c = make_tokens(1000, 16);
+    [[maybe_unused]] const std::size_t hit_c = cache.add_sequence(3, c);
+    assert(hit_c == 0 && "Test 3 Failed: unexpected hit");
+    assert(cache.stats().evictions == 2 && "Test 3 Failed: eviction count");
+
+    bool catch_exception = false;
+    try {
+        cache.add_sequence(4, make_tokens(5000, 4));
+    } catch (const std::runtime_error& e) {
+        catch_exception = true;
+        std::cout << "Expected exception caught: " << e.what() << std::endl;
+    }
+    assert(catch_exception && !cache.contains(4) && "Test 3 Failed: no exception when out of blocks");
+    assert(cache.stats().used_blocks == 4 && "Test 3 Failed: failed add leaked blocks");
+    std::cout << "Test 3 Succeeded" << std::endl << std::endl;
+}
+
+// Test 4: swap out under pressure and swap back in with data intact
+void test_swap() {
+    std::cout << "=== Test 4: Swap Out / Swap In ===" << std::endl;
+    Cache cache(small_config(4, 8));
+    auto a = make_tokens(0, 7);
+    auto b = make_tokens(500, 7);
+    cache.add_sequence(1, a);
+    write_prompt(cache, 1, a, 0);
+    cache.add_sequence(2, b);
+    write_prompt(cache, 2, b, 0);
+
+    // Sequence 1 is least recently used and gets swapped out to make room
+    auto c = make_tokens(900, 5);
+    cache.add_sequence(3, c);
+    write_prompt(cache, 3, c, 0);
+    assert(cache.is_swapped(1) && !cache.is_swapped(2) && "Test 4 Failed: wrong victim");
+
+    // Appending to a swapped sequence swaps it back in (and evicts another)
+    a.push_back(77);
+    write_token(cache, cache.append_token(1, 77), 77, 7);
+    assert(!cache.is_swapped(1) && "Test 4 Failed: sequence not swapped in");
+    assert(check_sequence(cache, 1, a) && "Test 4 Failed: KV data lost across swap");
+    cache.free_sequence(1);
+    cache.swap_in(2);
+    cache.swap_in(3);
+    assert(check_sequence(cache, 2, b) && check_sequence(cache, 3, c) && "Test 4 Failed: KV data lost across swap");
+    std::cout << "Test 4 Succeeded: swap_outs=" << cache.stats().swap_outs
+              << " swap_ins=" << cache.stats().swap_ins << std::endl << std::endl;
+}
+
+// Test 5: blocks are shared only after their KV is marked computed (failed add, free before prefill)
+void test_uncomputed_not_shared() {
+    std::cout << "=== Test 5: Uncomputed Blocks Are Not Shared ===" << std::endl;
+    Cache cache(small_config(3, 0));
+    cache.add_sequence(1, {1, 2});
+    auto p = make_tokens(100, 12);
+
+    bool catch_exception = false;
+    try {
+        cache.add_sequence(2, p);
+    } catch (const std::runtime_error&) {
+        catch_exception = true;
+    }
+    assert(catch_exception && !cache.contains(2) && "Test 5 Failed: add should run out of blocks");
+    assert(cache.stats().cached_blocks == 0 && "Test 5 Failed: rolled back blocks were cached");
+    cache.free_sequence(1);
+
+    [[maybe_unused]] const std::size_t hit_after_fail = cache.add_sequence(3, p);
+    assert(hit_after_fail == 0 && "Test 5 Failed: unwritten blocks reported as prefix hits");
+    // Freed between admission and prefill
+    cache.free_sequence(3);
+    [[maybe_unused]] const std::size_t hit_after_free = cache.add_sequence(4, p);
+    assert(hit_after_free == 0 && "Test 5 Failed: unwritten blocks reported as prefix hits");
+
+    write_prompt(cache, 4, p, 0);
+    cache.free_sequence(4);
+    [[maybe_unused]] const std::size_t hit_after_write = cache.add_sequence(5, p);
+    assert(hit_after_write == 12 && check_sequence(cache, 5, p) && "Test 5 Failed: computed blocks not reused");
+    std::cout << "Test 5 Succeeded" << std::endl << std::endl;
+}
+
+// Simulator: requests with a few shared system prompts, continuous batching with admission control
+void simulate() {
+    std::cout << "=== Simulator: Prefix Hit Rate And Memory Utilization ===" << std::endl;
+    KVCacheConfig config;
+    config.num_layers = 2;
+    config.num_kv_heads = 2;
+    config.head_dim = 8;
+    config.block_tokens = 16;
+    config.num_blocks = 512;
+    config.num_swap_blocks = 256;
+    Cache cache(config);
+
+    struct Request {
+        int64_t id;
+        std::vector<int32_t> tokens;
+        std::size_t output_len;
+        std::size_t generated = 0;
+    };
+
+    std::mt19937 gen(7);
+    const std::size_t num_requests = 400, system_len = 128, max_user = 96, max_output = 256;
+    std::vector<std::vector<int32_t>> system_prompts;
+    for (int s = 0; s < 4; ++s) system_prompts.push_back(make_tokens(10000 * (s + 1), system_len));
+
+    std::deque<Request> waiting;
+    for (std::size_t i = 0; i < num_requests; ++i) {
+        Request r;
+        r.id = static_cast<int64_t>(i);
+        r.tokens = system_prompts[gen() % system_prompts.size()];
+        const std::size_t user_len = 16 + gen() % (max_user - 16);
+        for (std::size_t t = 0; t < user_len; ++t) r.tokens.push_back(static_cast<int32_t>(gen() % 32000));
+        r.output_len = 32 + gen() % (max_output - 32);
+        waiting.push_back(std::move(r));
+    }
+
+    std::vector<Request> running;
+    const std::size_t bt = config.block_tokens;
+    auto blocks_of = [bt](std::size_t len) { return (len + bt - 1) / bt; };
+    std::size_t steps = 0, peak_running = 0, computed_prefill = 0, total_prefill = 0, recomputes = 0;
+    double util_sum = 0.0, used_sum = 0.0;
+    bool data_ok = true;
+    while (!waiting.empty() || !running.empty()) {
+        // 1. Resume swapped sequences first, in admission order
+        bool has_swapped = false;
+        for (auto& r : running) {
+            if (!cache.is_swapped(r.id)) continue;
+            if (!has_swapped && cache.can_allocate(blocks_of(r.tokens.size()) + 1)) {
+                cache.swap_in(r.id);
+            } else {
+                has_swapped = true;
+            }
+        }
+
+        // 2. Admit new (or preempted) requests while the prompt fits with a small watermark
+        while (!has_swapped && !waiting.empty() && running.size() < 64 &&
+               cache.can_allocate(blocks_of(waiting.front().tokens.size()) + 4)) {
+            Request r = std::move(waiting.front());
+            waiting.pop_front();
+            const std::size_t hit = cache.add_sequence(r.id, r.tokens);
+            write_prompt(cache, r.id, r.tokens, hit);
+            computed_prefill += r.tokens.size() - hit;
+            total_prefill += r.tokens.size();
+            running.push_back(std::move(r));
+        }
+
+        // 3. Reserve blocks for this decode step, preempting the newest sequences:
+        //    swap out while swap space lasts, otherwise drop and recompute later
+        auto needed = [&]() {
+            std::size_t n = 0;
+            for (auto& r : running) {
+                if (!cache.is_swapped(r.id) && r.tokens.size() % bt == 0) ++n;
+            }
+            return n;
+        };
+        while (!cache.can_allocate(needed())) {
+            auto victim = std::find_if(running.rbegin(), running.rend(),
+                [&](const Request& r) { return !cache.is_swapped(r.id); });
+            if (cache.free_swap_blocks() >= cache.block_table(victim->id).size()) {
+                cache.swap_out(victim->id);
+            } else {
+                cache.free_sequence(victim->id);
+                waiting.push_front(std::move(*victim));
+                running.erase(std::next(victim).base());
+                ++recomputes;
+            }
+        }
+
+        // 4. One decode step for every resident sequence
+        for (auto& r : running) {
+            if (cache.is_swapped(r.id)) continue;
+            const int32_t token = static_cast<int32_t>(gen() % 32000);
+            write_token(cache, cache.append_token(r.id, token), token, r.tokens.size());
+            r.tokens.push_back(token);
+            cache.mark_computed(r.id, r.tokens.size());
+            ++r.generated;
+        }
+
+        auto stats = cache.stats();
+        if (stats.used_blocks > 0) {
+            util_sum += static_cast<double>(stats.logical_tokens) / (stats.used_blocks * bt);
+        }
+        used_sum += static_cast<double>(stats.used_blocks) / config.num_blocks;
+        peak_running = std::max(peak_running, running.size());
+        ++steps;
+
+        for (auto it = running.begin(); it != running.end();) {
+            if (it->generated == it->output_len) {
+                data_ok = data_ok && check_sequence(cache, it->id, it->tokens);
+                cache.free_sequence(it->id);
+                it = running.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    assert(data_ok && "Simulator Failed: KV data mismatch");
+
+    auto stats = cache.stats();
+    const std::size_t max_len = system_len + max_user + max_output;
+    std::cout << "  requests:                     " << num_requests << " in " << steps << " steps" << std::endl;
+    std::cout << "  prefix hit rate:              " << stats.prefix_hit_rate() * 100.0 << " %" << std::endl;
+    std::cout << "  prefill tokens computed:      " << computed_prefill << " / " << total_prefill << std::endl;
+    std::cout << "  avg pool occupancy:           " << used_sum / steps * 100.0 << " %" << std::endl;
+    std::cout << "  avg tokens per used slot:     " << util_sum / steps * 100.0 << " % (>100% from sharing)" << std::endl;
+    std::cout << "  peak concurrent sequences:    " << peak_running << std::endl;
+    std::cout << "  contiguous max_len baseline:  " << config.num_blocks * config.block_tokens / max_len
+              << " sequences (" << max_len << " tokens reserved each)" << std::endl;
+    std::cout << "  evictions / swap outs / recomputes: " << stats.evictions << " / " << stats.swap_outs
+              << " / " << recomputes << std::endl;
+    std::cout << "  block size:                   " << cache.block_bytes() << " bytes" << std::endl << std::endl;
+}
+
+int main() {
+    try {
+        test_prefix_sharing();
+        test_fork_copy_on_write();
+        test_cached_reuse_and_eviction();
+        test_swap();
+        test_uncomputed_not_shared();
+        simulate();
+
+        std::cout << "=============================================" << std::endl;
+        std::cout << "✅ All test cases executed successfully!" << std::endl;
+        std::cout << "=============================================" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Uncaught exception during testing: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
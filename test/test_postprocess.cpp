@@ -0,0 +1,258 @@
+#include "src/kernel/postprocess.hpp"
+#include "src/core/thread_pool.hpp"
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <cassert>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <future>
+
+using postprocess::ScoreIndex;
+
+// Reference softmax in double precision
+static void softmax_ref(const float* in, double* out, std::size_t n) {
+    double m = in[0];
+    for (std::size_t i = 1; i < n; ++i) m = std::max<double>(m, in[i]);
+    double sum = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = std::exp(static_cast<double>(in[i]) - m);
+        sum += out[i];
+    }
+    for (std::size_t i = 0; i < n; ++i) out[i] /= sum;
+}
+
+// Reference top-k: stable full sort by score desc, index asc
+static std::vector<ScoreIndex> topk_ref(const float* x, std::size_t n, std::size_t k) {
+    std::vector<std::size_t> idx(n);
+    std::iota(idx.begin(), idx.end(), 0);
+    std::stable_sort(idx.begin(), idx.end(), [x](std::size_t a, std::size_t b) { return x[a] > x[b]; });
+    std::vector<ScoreIndex> res;
+    for (std::size_t i = 0; i < k; ++i) res.push_back({x[idx[i]], idx[i]});
+    return res;
+}
+
+// Bubble sort from test_sort.cpp, used as the baseline in benchmarks
+static void bubble_sort(std::vector<float>& vec) {
+    int n = vec.size();
+    for (int i = 0; i < n - 1; ++i) {
+        for (int j = 0; j < n - 1 - i; ++j) {
+            if (vec[j] > vec[j + 1]) {
+                std::swap(vec[j], vec[j + 1]);
+            }
+        }
+    }
+}
+
+static std::vector<float> random_logits(std::size_t count, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::normal_distribution<float> dist(0.0f, 4.0f);
+    std::vector<float> v(count);
+    for (auto& x : v) x = dist(gen);
+    return v;
+}
+
+template<typename F>
+static double time_us(F&& f, int repeat) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++i) f();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(stop - start).count() / repeat;
+}
+
+// Test 1: softmax / argmax / max against reference, including odd lengths (SIMD tail)
+void test_single_row() {
+    std::cout << "=== Test 1: Single Row Kernels vs Reference ===" << std::endl;
+    for (std::size_t n : {1u, 5u, 8u, 13u, 1000u, 1001u}) {
+        auto x = random_logits(n, static_cast<unsigned>(n));
+        // Large offset: naive exp(x) would overflow without max subtraction
+        for (auto& v : x) v += 500.0f;
+
+        std::vector<float> out(n);
+        std::vector<double> ref(n);
+        postprocess::softmax(x.data(), out.data(), n);
+        softmax_ref(x.data(), ref.data(), n);
+        double sum = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            assert(std::fabs(out[i] - ref[i]) <= 1e-6 + 1e-5 * ref[i] && "Test 1 Failed: softmax mismatch");
+            sum += out[i];
+        }
+        assert(std::fabs(sum - 1.0) < 1e-4 && "Test 1 Failed: softmax does not sum to 1");
+
+        auto ref_arg = static_cast<std::size_t>(std::max_element(x.begin(), x.end()) - x.begin());
+        assert(postprocess::argmax(x.data(), n) == ref_arg && "Test 1 Failed: argmax mismatch");
+        assert(postprocess::max_reduce(x.data(), n) == x[ref_arg] && "Test 1 Failed: max mismatch");
+    }
+    // In-place softmax
+    auto x = random_logits(37, 7);
+    std::vector<float> copy = x;
+    postprocess::softmax(x.data(), x.data(), x.size());
+    std::vector<float> out(copy.size());
+    postprocess::softmax(copy.data(), out.data(), copy.size());
+    assert(x == out && "Test 1 Failed: in-place softmax mismatch");
+    std::cout << "Test 1 Succeeded" << std::endl << std::endl;
+}
+
+// Test 2: top-k against stable sort, including ties and k boundaries
+void test_topk() {
+    std::cout << "=== Test 2: Top-K vs Reference ===" << std::endl;
+    for (std::size_t n : {5u, 9u, 64u, 1000u}) {
+        for (std::size_t k : {1u, 5u}) {
+            if (k > n) continue;
+            auto x = random_logits(n, static_cast<unsigned>(n * 31 + k));
+            // Quantize to force ties
+            for (auto& v : x) v = std::round(v);
+            std::vector<ScoreIndex> out(k);
+            postprocess::topk(x.data(), n, k, out.data());
+            auto ref = topk_ref(x.data(), n, k);
+            for (std::size_t i = 0; i < k; ++i) {
+                assert(out[i].score == ref[i].score && out[i].index == ref[i].index && "Test 2 Failed: topk mismatch");
+            }
+        }
+    }
+    // Descending input: every element is a candidate
+    std::vector<float> desc(100);
+    for (std::size_t i = 0; i < desc.size(); ++i) desc[i] = -static_cast<float>(i);
+    std::vector<ScoreIndex> out(5);
+    postprocess::topk(desc.data(), desc.size(), 5, out.data());
+    for (std::size_t i = 0; i < 5; ++i) assert(out[i].index == i && "Test 2 Failed: descending input");
+
+    bool catch_exception = false;
+    try {
+        postprocess::topk(desc.data(), 3, 5, out.data());
+    } catch (const std::invalid_argument&) {
+        catch_exception = true;
+    }
+    assert(catch_exception && "Test 2 Failed: k > n should throw");
+    std::cout << "Test 2 Succeeded" << std::endl << std::endl;
+}
+
+// Test 3: batched kernels on ThreadPool match the single row kernels
+void test_batch(ThreadPool& pool) {
+    std::cout << "=== Test 3: Batched Kernels on ThreadPool ===" << std::endl;
+    const std::size_t batch = 37, n = 1000, k = postprocess::DEFAULT_TOPK;
+    auto x = random_logits(batch * n, 42);
+
+    std::vector<float> prob(batch * n);
+    std::vector<std::size_t> arg(batch);
+    std::vector<ScoreIndex> top(batch * k);
+    postprocess::softmax_batch(pool, x.data(), prob.data(), batch, n);
+    postprocess::argmax_batch(pool, x.data(), arg.data(), batch, n);
+    postprocess::topk_batch(pool, x.data(), top.data(), batch, n, k);
+
+    std::vector<float> row(n);
+    std::vector<ScoreIndex> row_top(k);
+    for (std::size_t r = 0; r < batch; ++r) {
+        const float* xr = x.data() + r * n;
+        postprocess::softmax(xr, row.data(), n);
+        assert(std::equal(row.begin(), row.end(), prob.begin() + r * n) && "Test 3 Failed: softmax_batch mismatch");
+        assert(arg[r] == postprocess::argmax(xr, n) && "Test 3 Failed: argmax_batch mismatch");
+        postprocess::topk(xr, n, k, row_top.data());
+        for (std::size_t i = 0; i < k; ++i) {
+            assert(top[r * k + i].index == row_top[i].index && "Test 3 Failed: topk_batch mismatch");
+        }
+        assert(top[r * k].index == arg[r] && "Test 3 Failed: top-1 != argmax");
+    }
+
+    // Every chunk throws on empty rows; the first error is rethrown after all chunks finish
+    bool catch_exception = false;
+    try {
+        postprocess::argmax_batch(pool, x.data(), arg.data(), batch, 0);
+    } catch (const std::invalid_argument&) {
+        catch_exception = true;
+    }
+    assert(catch_exception && "Test 3 Failed: exception not propagated from batch");
+
+    // Called from a worker of the same pool (e.g. a co_await postprocess stage): runs inline instead of deadlocking
+    ThreadPool single(1);
+    std::vector<std::size_t> nested(batch);
+    auto done = single.enqueue([&]() { postprocess::argmax_batch(single, x.data(), nested.data(), batch, n); });
+    [[maybe_unused]] const auto status = done.wait_for(std::chrono::seconds(10));
+    assert(status == std::future_status::ready && "Test 3 Failed: batch call on a worker deadlocked");
+    done.get();
+    assert(nested == arg && "Test 3 Failed: inline batch mismatch");
+    std::cout << "Test 3 Succeeded" << std::endl << std::endl;
+}
+
+// Benchmark: top-k vs std::partial_sort vs bubble sort, softmax vs scalar, batch vs serial
+void bench(ThreadPool& pool) {
+    std::cout << "=== Benchmark (N x 1000 logits) ===" << std::endl;
+    const std::size_t batch = 256, n = 1000, k = postprocess::DEFAULT_TOPK;
+    auto x = random_logits(batch * n, 2024);
+    std::vector<ScoreIndex> top(batch * k);
+    std::vector<float> prob(batch * n);
+    std::vector<std::size_t> idx(n);
+    volatile std::size_t sink = 0;
+
+    double t_topk = time_us([&]() {
+        for (std::size_t r = 0; r < batch; ++r) postprocess::topk(x.data() + r * n, n, k, top.data() + r * k);
+    }, 20) / batch;
+    double t_partial = time_us([&]() {
+        for (std::size_t r = 0; r < batch; ++r) {
+            const float* xr = x.data() + r * n;
+            std::iota(idx.begin(), idx.end(), 0);
+            std::partial_sort(idx.begin(), idx.begin() + k, idx.end(),
+                [xr](std::size_t a, std::size_t b) { return xr[a] > xr[b]; });
+            sink = sink + idx[0];
+        }
+    }, 20) / batch;
+    double t_bubble = time_us([&]() {
+        std::vector<float> row(x.begin(), x.begin() + n);
+        bubble_sort(row);
+        sink = sink + static_cast<std::size_t>(row[n - 1]);
+    }, 5);
+
+    double t_softmax = time_us([&]() {
+        for (std::size_t r = 0; r < batch; ++r) postprocess::softmax(x.data() + r * n, prob.data() + r * n, n);
+    }, 20) / batch;
+    std::vector<double> ref(n);
+    double t_softmax_ref = time_us([&]() {
+        for (std::size_t r = 0; r < batch; ++r) softmax_ref(x.data() + r * n, ref.data(), n);
+    }, 20) / batch;
+
+    double t_serial = time_us([&]() {
+        for (std::size_t r = 0; r < batch; ++r) {
+            postprocess::softmax(x.data() + r * n, prob.data() + r * n, n);
+            postprocess::topk(x.data() + r * n, n, k, top.data() + r * k);
+        }
+    }, 20);
+    double t_batch = time_us([&]() {
+        postprocess::softmax_batch(pool, x.data(), prob.data(), batch, n);
+        postprocess::topk_batch(pool, x.data(), top.data(), batch, n, k);
+    }, 20);
+
+#if POSTPROCESS_USE_AVX2
+    std::cout << "  SIMD path: AVX2" << std::endl;
+#else
+    std::cout << "  SIMD path: scalar (configure with -DENABLE_AVX2=ON for AVX2)" << std::endl;
+#endif
+    std::cout << "  top-5 per row:          " << t_topk << " us" << std::endl;
+    std::cout << "  std::partial_sort:      " << t_partial << " us" << std::endl;
+    std::cout << "  bubble sort:            " << t_bubble << " us" << std::endl;
+    std::cout << "  softmax per row:        " << t_softmax << " us" << std::endl;
+    std::cout << "  reference softmax:      " << t_softmax_ref << " us" << std::endl;
+    std::cout << "  softmax+top5 serial:    " << t_serial << " us (" << batch << " rows)" << std::endl;
+    std::cout << "  softmax+top5 batched:   " << t_batch << " us (" << pool.thread_count() << " threads)" << std::endl;
+    (void)sink;
+}
+
+int main() {
+    try {
+        ThreadPool pool;
+        test_single_row();
+        test_topk();
+        test_batch(pool);
+        bench(pool);
+
+        std::cout << "=============================================" << std::endl;
+        std::cout << "✅ All test cases executed successfully!" << std::endl;
+        std::cout << "=============================================" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Uncaught exception during testing: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
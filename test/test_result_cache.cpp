@@ -0,0 +1,266 @@
+#include "src/core/result_cache.hpp"
+#include "src/core/thread_pool.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <cassert>
+#include <stdexcept>
+
+using Logits = std::vector<float>;
+
+// Simulated inference: expensive and deterministic in the input bytes
+static Logits fake_inference(const std::vector<uint8_t>& frame, std::atomic<int>& calls) {
+    calls.fetch_add(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    Logits out(1000, 0.0f);
+    out[frame[0] % 1000] = 1.0f;
+    return out;
+}
+
+static std::vector<uint8_t> make_frame(uint8_t value, std::size_t size = 224 * 224 * 3) {
+    return std::vector<uint8_t>(size, value);
+}
+
+// Test 1: xxHash64 reference values and key separation
+void test_hash() {
+    std::cout << "=== Test 1: Content Hash ===" << std::endl;
+    assert(xxhash64("", 0) == 0xEF46DB3751D8E999ull && "Test 1 Failed: empty input hash");
+    assert(xxhash64("abc", 3) == 0x44BC2CF5AD770999ull && "Test 1 Failed: short input hash");
+    auto a = make_frame(1), b = make_frame(1);
+    assert(xxhash64(a.data(), a.size()) == xxhash64(b.data(), b.size()) && "Test 1 Failed: hash not deterministic");
+    b[b.size() / 2] ^= 1;
+    assert(xxhash64(a.data(), a.size()) != xxhash64(b.data(), b.size()) && "Test 1 Failed: single bit flip not detected");
+    std::cout << "Test 1 Succeeded" << std::endl << std::endl;
+}
+
+// Test 2: hit/miss accounting, model id is part of the key
+void test_hit_miss() {
+    std::cout << "=== Test 2: Hit / Miss And Model Id ===" << std::endl;
+    ResultCache<Logits> cache;
+    std::atomic<int> calls{0};
+    auto frame = make_frame(7);
+
+    auto r1 = cache.get_or_compute("resnet50", frame.data(), frame.size(), [&]() { return fake_inference(frame, calls); });
+    auto r2 = cache.get_or_compute("resnet50", frame.data(), frame.size(), [&]() { return fake_inference(frame, calls); });
+    auto r3 = cache.get_or_compute("yolov5", frame.data(), frame.size(), [&]() { return fake_inference(frame, calls); });
+    assert(r1 == r2 && r1 != r3 && calls.load() == 2 && "Test 2 Failed: incorrect caching");
+    assert((*r1)[7] == 1.0f && "Test 2 Failed: incorrect cached value");
+    assert(cache.lookup("clip", frame.data(), frame.size()) == nullptr && "Test 2 Failed: unexpected hit");
+
+    auto stats = cache.stats();
+    assert(stats.hits == 1 && stats.misses == 3 && stats.entries == 2 && "Test 2 Failed: stats mismatch");
+    std::cout << "Test 2 Succeeded: hit rate = " << stats.hit_rate() << std::endl << std::endl;
+}
+
+// Test 3: TTL expiry and memory cap eviction (CLOCK keeps recently referenced entries)
+void test_ttl_and_capacity() {
+    std::cout << "=== Test 3: TTL And Memory Cap ===" << std::endl;
+    ResultCacheConfig config;
+    config.ttl = std::chrono::milliseconds(50);
+    ResultCache<Logits> ttl_cache(config);
+    auto frame = make_frame(1);
+    ttl_cache.insert("m", frame.data(), frame.size(), Logits(10, 1.0f));
+    assert(ttl_cache.lookup("m", frame.data(), frame.size()) != nullptr && "Test 3 Failed: entry missing before TTL");
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    assert(ttl_cache.lookup("m", frame.data(), frame.size()) == nullptr && "Test 3 Failed: entry alive after TTL");
+    assert(ttl_cache.stats().expirations == 1 && "Test 3 Failed: expiration count");
+
+    // One shard, room for exactly 3 entries of 1000 floats
+    ResultCacheConfig small;
+    small.num_shards = 1;
+    small.max_bytes = 3 * (sizeof(Logits) + 1000 * sizeof(float));
+    ResultCache<Logits> cache(small);
+    std::vector<std::vector<uint8_t>> frames;
+    for (uint8_t i = 0; i < 4; ++i) frames.push_back(make_frame(i, 64));
+    for (int i = 0; i < 3; ++i) cache.insert("m", frames[i].data(), frames[i].size(), Logits(1000));
+    // Touch entry 0 so it gets a second chance
+    [[maybe_unused]] const auto touched = cache.lookup("m", frames[0].data(), frames[0].size());
+    assert(touched != nullptr && "Test 3 Failed: entry 0 missing before eviction");
+    cache.insert("m", frames[3].data(), frames[3].size(), Logits(1000));
+
+    auto stats = cache.stats();
+    assert(stats.entries == 3 && stats.evictions == 1 && stats.bytes <= small.max_bytes && "Test 3 Failed: cap not enforced");
+    assert(cache.lookup("m", frames[0].data(), frames[0].size()) != nullptr && "Test 3 Failed: referenced entry evicted");
+    assert(cache.lookup("m", frames[1].data(), frames[1].size()) == nullptr && "Test 3 Failed: CLOCK victim mismatch");
+    std::cout << "Test 3 Succeeded" << std::endl << std::endl;
+}
+
+// Test 4: concurrent identical requests share one computation; failures are not cached
+void test_inflight_dedup() {
+    std::cout << "=== Test 4: In-Flight Deduplication ===" << std::endl;
+    ResultCache<Logits> cache;
+    std::atomic<int> calls{0};
+    auto frame = make_frame(42);
+
+    std::vector<std::thread> threads;
+    std::vector<ResultCache<Logits>::ValuePtr> results(16);
+    for (int i = 0; i < 16; ++i) {
+        threads.emplace_back([&, i]() {
+            results[i] = cache.get_or_compute("resnet50", frame.data(), frame.size(), [&]() {
+                calls.fetch_add(1);
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                return Logits(1000, 0.5f);
+            });
+        });
+    }
+    for (auto& t : threads) t.join();
+    assert(calls.load() == 1 && "Test 4 Failed: duplicate computation");
+    for (auto& r : results) assert(r == results[0] && "Test 4 Failed: results not shared");
+    auto stats = cache.stats();
+    assert(stats.misses == 1 && stats.hits + stats.inflight_hits == 15 && "Test 4 Failed: stats mismatch");
+
+    auto bad = make_frame(9);
+    for (int i = 0; i < 2; ++i) {
+        bool catch_exception = false;
+        try {
+            cache.get_or_compute("resnet50", bad.data(), bad.size(), []() -> Logits { throw std::runtime_error("engine error"); });
+        } catch (const std::runtime_error&) {
+            catch_exception = true;
+        }
+        assert(catch_exception && "Test 4 Failed: exception not propagated");
+    }
+    assert(cache.stats().misses == 3 && "Test 4 Failed: failed result was cached");
+    std::cout << "Test 4 Succeeded: " << stats.inflight_hits << " requests joined the in-flight computation" << std::endl << std::endl;
+}
+
+// Test 5: asynchronous path on ThreadPool
+void test_submit(ThreadPool& pool) {
+    std::cout << "=== Test 5: Cached Submission On ThreadPool ===" << std::endl;
+    ResultCache<Logits> cache;
+    std::atomic<int> calls{0};
+    std::vector<std::vector<uint8_t>> frames;
+    for (uint8_t i = 0; i < 4; ++i) frames.push_back(make_frame(i));
+
+    std::vector<std::shared_future<ResultCache<Logits>::ValuePtr>> futures;
+    for (int round = 0; round < 8; ++round) {
+        for (auto& f : frames) {
+            futures.push_back(cache.submit(pool, "resnet50", f.data(), f.size(),
+                [&f, &calls]() { return fake_inference(f, calls); }));
+        }
+    }
+    // Wait on every future before frames go out of scope
+    for (std::size_t i = 0; i < futures.size(); ++i) {
+        [[maybe_unused]] const auto result = futures[i].get();
+        assert((*result)[i % frames.size()] == 1.0f && "Test 5 Failed: incorrect result");
+    }
+    assert(calls.load() == 4 && "Test 5 Failed: duplicate computation on pool");
+    std::cout << "Test 5 Succeeded" << std::endl << std::endl;
+}
+
+#if defined(__cpp_impl_coroutine)
+// Test 6: co_await path; a hit stays on the caller, concurrent misses share one computation
+void test_coroutine(ThreadPool& pool) {
+    std::cout << "=== Test 6: Coroutine Entry Point ===" << std::endl;
+    ResultCache<Logits> cache;
+    ThreadPoolExecutor ex(pool);
+    std::atomic<int> calls{0};
+    auto frame = make_frame(11);
+
+    auto inference = [&]() -> Task<Logits> {
+        co_await ex.schedule();
+        co_return fake_inference(frame, calls);
+    };
+    std::vector<Task<ResultCache<Logits>::ValuePtr>> tasks;
+    for (int i = 0; i < 8; ++i) {
+        tasks.push_back(cache.co_get_or_compute(pool, "resnet50", frame.data(), frame.size(), inference));
+    }
+    const auto results = sync_wait(when_all(std::move(tasks)));
+    assert(calls.load() == 1 && "Test 6 Failed: duplicate computation");
+    assert(cache.stats().misses == 1 && cache.stats().hits + cache.stats().inflight_hits == 7 && "Test 6 Failed: waiters did not join");
+    for (auto& r : results) assert(r == results[0] && (*r)[11] == 1.0f && "Test 6 Failed: results not shared");
+
+    const auto main_id = std::this_thread::get_id();
+    auto on_hit = [&]() -> Task<bool> {
+        co_await cache.co_get_or_compute(pool, "resnet50", frame.data(), frame.size(), inference);
+        co_return std::this_thread::get_id() == main_id;
+    };
+    [[maybe_unused]] const bool stayed = sync_wait(on_hit());
+    assert(stayed && calls.load() == 1 && "Test 6 Failed: hit should not switch threads");
+
+    auto bad = make_frame(12);
+    auto failing = [&]() -> Task<Logits> {
+        co_await ex.schedule();
+        throw std::runtime_error("engine error");
+    };
+    bool catch_exception = false;
+    try {
+        sync_wait(cache.co_get_or_compute(pool, "resnet50", bad.data(), bad.size(), failing));
+    } catch (const std::runtime_error&) {
+        catch_exception = true;
+    }
+    assert(catch_exception && "Test 6 Failed: exception not propagated");
+    std::cout << "Test 6 Succeeded" << std::endl << std::endl;
+}
+#endif
+
+// Benchmark: hash throughput and a camera-like stream where 70% of frames repeat
+void bench(ThreadPool& pool) {
+    std::cout << "=== Benchmark ===" << std::endl;
+    auto frame = make_frame(3);
+    const int hash_rounds = 200;
+    volatile uint64_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < hash_rounds; ++i) sink = sink + xxhash64(frame.data(), frame.size());
+    auto t1 = std::chrono::steady_clock::now();
+    const double hash_us = std::chrono::duration<double, std::micro>(t1 - t0).count() / hash_rounds;
+    std::cout << "  xxhash64 224x224x3 frame: " << hash_us << " us ("
+              << frame.size() / hash_us / 1000.0 << " GB/s)" << std::endl;
+
+    std::mt19937 gen(1);
+    std::vector<std::vector<uint8_t>> stream;
+    for (int i = 0; i < 400; ++i) {
+        const bool repeat = !stream.empty() && gen() % 10 < 7;
+        stream.push_back(repeat ? stream[gen() % stream.size()] : make_frame(static_cast<uint8_t>(gen())));
+    }
+
+    std::atomic<int> calls{0};
+    auto s0 = std::chrono::steady_clock::now();
+    std::vector<std::future<Logits>> plain;
+    for (auto& f : stream) plain.push_back(pool.enqueue([&f, &calls]() { return fake_inference(f, calls); }));
+    for (auto& p : plain) p.get();
+    auto s1 = std::chrono::steady_clock::now();
+    const int plain_calls = calls.exchange(0);
+
+    ResultCache<Logits> cache;
+    std::vector<std::shared_future<ResultCache<Logits>::ValuePtr>> cached;
+    for (auto& f : stream) {
+        cached.push_back(cache.submit(pool, "resnet50", f.data(), f.size(), [&f, &calls]() { return fake_inference(f, calls); }));
+    }
+    for (auto& c : cached) c.get();
+    auto s2 = std::chrono::steady_clock::now();
+
+    using ms = std::chrono::duration<double, std::milli>;
+    auto stats = cache.stats();
+    std::cout << "  uncached: " << ms(s1 - s0).count() << " ms, " << plain_calls << " inferences" << std::endl;
+    std::cout << "  cached:   " << ms(s2 - s1).count() << " ms, " << calls.load() << " inferences" << std::endl;
+    std::cout << "  hits=" << stats.hits << " inflight_hits=" << stats.inflight_hits << " misses=" << stats.misses
+              << " hit_rate=" << stats.hit_rate() << std::endl;
+    (void)sink;
+}
+
+int main() {
+    try {
+        ThreadPool pool(4);
+        test_hash();
+        test_hit_miss();
+        test_ttl_and_capacity();
+        test_inflight_dedup();
+        test_submit(pool);
+#if defined(__cpp_impl_coroutine)
+        test_coroutine(pool);
+#endif
+        bench(pool);
+
+        std::cout << "=============================================" << std::endl;
+        std::cout << "✅ All test cases executed successfully!" << std::endl;
+        std::cout << "=============================================" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Uncaught exception during testing: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}